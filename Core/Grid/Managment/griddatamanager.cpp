@@ -14,250 +14,819 @@
 #include "../TaskSystem/taskscheduler.h"
 
 #include <QTimer>
+#include <QFile>
+#include <QPointer>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace
+{
+qint64 residentSetBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if(statm.open(QIODevice::ReadOnly))
+    {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if(fields.size() > 1)
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+}
 
 GridDataManager::GridDataManager(TaskScheduler* scheduler, QObject* parent)
     : m_scheduler(scheduler),
-    m_monitor{new NetworkMonitor{nullptr, this}},//TODO: mb use "old" syntaxis
+    m_monitor{new NetworkMonitor{scheduler, this}},//TODO: mb use "old" syntaxis
     m_sorter{ComponentRegistry::create<INetworkSortStrategy>()},
     m_parser{ComponentRegistry::create<IParser>(nullptr)},
+    m_snapshot{std::make_shared<const Snapshot>()},
     QObject{parent}
 {
     connect(m_parser.get(), &IParser::parsingCompleted,
             this, &GridDataManager::handleParsingCompleted, Qt::QueuedConnection);
+    // Emitted on the pool, where the sample is only queued
     connect(m_monitor, &NetworkMonitor::statsUpdated,
-            this, &GridDataManager::handleNetworkStats);
+            this, &GridDataManager::handleNetworkStats, Qt::DirectConnection);
 
-    m_scheduler->scheduleRepeating("data_refresh", 2000, this,
+    m_scheduler->scheduleRepeating("data_refresh", REFRESH_INTERVAL_DEFAULT, this,
                                    &GridDataManager::refreshData,
                                    QThread::NormalPriority);
+    m_monitor->startMonitoring(STATS_INTERVAL_DEFAULT);
 
-    Logger::instance().log(Logger::Info, "GridDataManager initialized", "Grid");
+    LOG_INFO("Grid", "GridDataManager initialized");
 }
 
 GridDataManager::~GridDataManager()
 {
+    // The scheduler outlives this object; its timers must not fire into it
+    m_scheduler->cancelRepeating("data_refresh");
+    m_monitor->stopMonitoring();
     clearGrid();
 }
 
-NetworkInfoModel* GridDataManager::cellData(QPoint indx) const
+// Models are created here, when a view binds a visible cell, and not when
+// the interface is parsed or scrolled past
+NetworkInfoModel* GridDataManager::cellData(QPoint indx)
+{
+    const int slot = slotIndex(indx);
+    if(slot < 0)
+        return nullptr;
+
+    CellSlot& cell = m_slots[slot];
+    if(!cell.model && cell.info && isRowVisible(indx.x()))
+    {
+        // Rebinding a pooled model notifies its views; not under the lock
+        NetworkInfoModel* model = acquireModel(cell.info);
+        QMutexLocker lock(&m_dataMutex);
+        cell.model = model;
+    }
+    return cell.model;
+}
+
+GridDataManager::CellHandle GridDataManager::cellHandle(const QPoint& indx) const
 {
-    if (indx.x() >= 0 && indx.x() < m_data.size() &&
-        indx.y() >= 0 && indx.y() < m_data[indx.x()].size())
+    CellHandle handle;
+    const int slot = slotIndex(indx);
+    if(slot >= 0)
     {
-        return m_data[indx.x()][indx.y()];
+        handle.slot = slot;
+        handle.generation = m_slots[slot].generation;
     }
-    return nullptr;
+    return handle;
+}
+
+QPoint GridDataManager::cellPosition(const CellHandle& handle) const
+{
+    return isCurrent(handle) ? slotPosition(handle.slot) : QPoint(-1, -1);
 }
 
 int GridDataManager::getRows() const
 {
-    return m_data.size();
+    return m_rows;
 }
 
 int GridDataManager::getCols() const
 {
-    return m_data.isEmpty() ? 0 : m_data[0].size();
+    return m_cols;
+}
+
+int GridDataManager::interfaceCount() const
+{
+    return m_nameIndex.size();
+}
+
+// Rows the views show at once; getRows() grows past it with the interfaces
+int GridDataManager::getViewportRows() const
+{
+    return m_minRows;
+}
+
+GridDataManager::SnapshotPtr GridDataManager::snapshot() const
+{
+    return m_snapshot.load(std::memory_order_acquire);
+}
+
+QVector<GridDataManager::InterfaceSummary> GridDataManager::interfaceSummaries() const
+{
+    return snapshot()->interfaces;
+}
+
+NetworkInfoModel* GridDataManager::createDetachedModel(const QPoint& indx)
+{
+    QMutexLocker lock(&m_dataMutex);
+    const int slot = slotIndex(indx);
+    NetworkInfo* info = slot >= 0 ? m_slots[slot].info : nullptr;
+    if(!info)
+        return nullptr;
+
+    NetworkInfoModel* model = new NetworkInfoModel(info);
+    connect(info, &QObject::destroyed, model, [model]()
+            {
+                delete model;
+            });
+    return model;
+}
+
+// GUI thread. NetworkInfo, stats included, is only written there, so no
+// writer can be calling into the model while it is unbound; the unbind
+// still takes m_dataMutex like every other change to grid data
+void GridDataManager::releaseDetachedModel(NetworkInfoModel* model)
+{
+    if(!model)
+        return;
+
+    {
+        QMutexLocker lock(&m_dataMutex);
+        model->rebind(nullptr);
+    }
+    model->deleteLater();
 }
 
 void GridDataManager::initializeGrid(int rows, int cols)
 {
-    clearGrid();
-    m_data.resize(rows);
-    for(auto& row : m_data)
     {
-        row.resize(cols);
+        QMutexLocker lock(&m_dataMutex);
+        clearGrid();
+        m_minRows = rows;
+        m_cols = cols;
+        m_firstVisibleRow = 0;
+        m_visibleRowCount = rows;
+        m_rows = rows;
+        m_slots.resize(rows * cols);
+        for(CellSlot& slot : m_slots)
+        {
+            slot.generation = nextGeneration();
+        }
     }
 
+    publishSnapshot();
     refreshData();
     emit gridDimensionsChanged();
 }
 
+// Cells keep their (row, col) where it still exists; interfaces from
+// dropped rows or columns move to the free slots in their previous order.
+void GridDataManager::resizeGrid(int rows, int cols)
+{
+    if(m_cols <= 0 || cols <= 0)
+    {
+        initializeGrid(rows, cols);
+        return;
+    }
+    if(rows == m_minRows && cols == m_cols)
+        return;
+
+    const int oldRows = m_rows;
+    const int oldCols = m_cols;
+    QList<QPoint> changedCells;
+    {
+        QMutexLocker lock(&m_dataMutex);
+        const QVector<CellSlot> oldSlots = std::move(m_slots);
+
+        // The current layout expressed in the new geometry, and the shown
+        // order: kept cells first so they never count as reordered
+        QStringList layout;
+        QVector<int> order;
+        QVector<int> displaced;
+        for(int i = 0; i < oldSlots.size(); ++i)
+        {
+            if(!oldSlots[i].info)
+                continue;
+
+            const int r = i / oldCols;
+            const int c = i % oldCols;
+            if(c < cols)
+            {
+                const int target = r * cols + c;
+                if(layout.size() <= target)
+                    layout.resize(target + 1);
+                layout[target] = oldSlots[i].info->getName();
+                order.append(i);
+            }
+            else
+            {
+                displaced.append(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [oldCols, cols](int a, int b)
+                  {
+                      return (a / oldCols) * cols + a % oldCols < (b / oldCols) * cols + b % oldCols;
+                  });
+        order += displaced;
+
+        QStringList ranked;
+        ranked.reserve(order.size());
+        for(int i : std::as_const(order))
+        {
+            ranked.append(oldSlots[i].info->getName());
+        }
+
+        m_minRows = rows;
+        m_cols = cols;
+        const GridPlacement::Result placement = m_placement.place(layout, ranked, m_pinnedNames, cols, rows);
+        m_rows = placement.rows;
+        m_slots = QVector<CellSlot>(m_rows * m_cols);
+        m_nameIndex.clear();
+        QVector<bool> occupied(m_slots.size(), false);
+
+        for(int k = 0; k < order.size(); ++k)
+        {
+            const int from = order[k];
+            const int target = placement.slots[k];
+            CellSlot slot = oldSlots[from];
+            if(from != target || oldCols != cols)
+                slot.generation = nextGeneration();
+            syncModel(slot, target / m_cols);
+            m_slots[target] = slot;
+            occupied[target] = true;
+            m_nameIndex.insert(ranked[k], target);
+        }
+        for(int i = 0; i < m_slots.size(); ++i)
+        {
+            if(!occupied[i])
+                m_slots[i].generation = nextGeneration();
+        }
+
+        // Positions are compared by (row, col) since the stride may differ
+        for(int i = 0; i < m_slots.size(); ++i)
+        {
+            const QPoint pos = slotPosition(i);
+            if(!isRowVisible(pos.x()))
+                continue;
+            const int before = pos.y() < oldCols && pos.x() < oldRows ? pos.x() * oldCols + pos.y() : -1;
+            const CellSlot empty;
+            const CellSlot& old = before >= 0 ? oldSlots[before] : empty;
+            if(m_slots[i].info != old.info || m_slots[i].model != old.model)
+                changedCells.append(pos);
+        }
+    }
+
+    LOG_INFO("Grid", "Grid resized to %1x%2 (%3 rows in use)", rows, cols, m_rows);
+    emit gridDimensionsChanged();
+    for(const QPoint& pos : changedCells)
+    {
+        emit cellChanged(pos);
+    }
+    publishSnapshot();
+}
+
 void GridDataManager::swapCells(const QPoint& from, const QPoint& to)
 {
-    m_scheduler->schedule(QString("grid_swap"),
-                          this,
-                          &GridDataManager::swapCellsImpl,
-                          QThread::HighPriority,
-                          from,
-                          to);
+    const CellHandle fromHandle = cellHandle(from);
+    const CellHandle toHandle = cellHandle(to);
+    if(fromHandle.slot < 0 || toHandle.slot < 0)
+    {
+        LOG_WARNING("Grid", "Invalid swap coordinates (%1,%2) -> (%3,%4)",
+                    from.x(), from.y(), to.x(), to.y());
+        return;
+    }
+
+    // The grid is restructured on the GUI thread only. The swap is queued,
+    // so it carries handles: a re-parse in between must not make it move
+    // whatever ended up at those positions.
+    m_scheduler->scheduleMainThread(QString("grid_swap"),
+                                    [this, fromHandle, toHandle]
+                                    {
+                                        swapCellsImpl(fromHandle, toHandle);
+                                    },
+                                    QThread::HighPriority);
+}
+
+void GridDataManager::setCellPinned(const QPoint& indx, bool pinned)
+{
+    const int slot = slotIndex(indx);
+    if(slot < 0 || !m_slots[slot].info)
+        return;
+
+    const QString name = m_slots[slot].info->getName();
+    if(pinned)
+        m_pinnedNames.insert(name);
+    else
+        m_pinnedNames.remove(name);
+    LOG_INFO("Grid", "Interface %1 %2 at (%3,%4)", name, pinned ? "pinned" : "unpinned", indx.x(), indx.y());
+}
+
+bool GridDataManager::isCellPinned(const QPoint& indx) const
+{
+    const int slot = slotIndex(indx);
+    return slot >= 0 && m_slots[slot].info && m_pinnedNames.contains(m_slots[slot].info->getName());
+}
+
+void GridDataManager::setReorderTolerance(int positions)
+{
+    m_placement.setRankTolerance(positions);
+}
+
+void GridDataManager::setVisibleRows(int firstRow, int rowCount)
+{
+    if(firstRow == m_firstVisibleRow && rowCount == m_visibleRowCount)
+        return;
+
+    QMutexLocker lock(&m_dataMutex);
+    const int oldFirst = m_firstVisibleRow;
+    const int oldLast = m_firstVisibleRow + m_visibleRowCount;
+    m_firstVisibleRow = qMax(0, firstRow);
+    m_visibleRowCount = qMax(0, rowCount);
+
+    // Only rows entering or leaving the range need their models touched
+    const int first = qMin(oldFirst, m_firstVisibleRow) * m_cols;
+    const int last = qMin(m_rows, qMax(oldLast, m_firstVisibleRow + m_visibleRowCount)) * m_cols;
+    for(int i = first; i < last; ++i)
+    {
+        CellSlot& slot = m_slots[i];
+        NetworkInfoModel* oldModel = slot.model;
+        syncModel(slot, i / m_cols);
+        if(slot.model != oldModel)
+        {
+            emit cellChanged(slotPosition(i));
+        }
+    }
+}
+
+void GridDataManager::setSamplingIntervals(int refreshMs, int statsMs)
+{
+    m_scheduler->setRepeatingInterval("data_refresh", refreshMs);
+    m_monitor->setInterval(statsMs);
+}
+
+void GridDataManager::sampleNow()
+{
+    m_scheduler->triggerRepeating("data_refresh");
+    m_monitor->sampleNow();
 }
 
 void GridDataManager::handleParsingCompleted(const QVariant& result)
 {
     Q_ASSERT(result.canConvert<QList<NetworkInfo*>>());
-    QVariant resultCopy = result;
-    m_scheduler->scheduleAtomic(m_refreshInProgress,
-                                QString("data_processing"),
-                                this,
-                                &GridDataManager::handleParsingCompletedImpl,
-                                QThread::NormalPriority,
-                                std::move(resultCopy));
+    processParsingResult(result);
 }
 
-void GridDataManager::handleNetworkStats(const QString& mac, const quint64& rxSpeed, const quint64& txSpeed)
+// Nothing keeps this object alive across the suspensions: the pool step
+// only touches copies, and the GUI step checks that it still exists
+CoTask GridDataManager::processParsingResult(QVariant result)
 {
-    m_scheduler->schedule(QString("stats_update"),
-                          this,
-                          &GridDataManager::handleNetworkStatsImpl,
-                          QThread::LowPriority,
-                          std::forward<const QString&>(mac),
-                          rxSpeed,
-                          txSpeed);
+    const QPointer<GridDataManager> self(this);
+    TaskScheduler* scheduler = m_scheduler;
+    const std::shared_ptr<INetworkSortStrategy> sorter = m_sorter;
+    m_refreshInProgress.ref();
+
+    co_await scheduler->onPool(QString("data_processing"));
+    const QList<NetworkInfo*> infos = handleParsingCompletedImpl(sorter, std::move(result));
+
+    co_await scheduler->onMainThread();
+    if(!self)
+    {
+        qDeleteAll(infos);
+        co_return;
+    }
+    applyParsedInfos(infos);
+    m_refreshInProgress.deref();
+}
+
+// The GUI reads NetworkInfo without a lock, so the values are only
+// queued here and written in the next publishSnapshot() pass
+void GridDataManager::handleNetworkStats(const QString& name, quint64 rxSpeed, quint64 txSpeed)
+{
+    StatsSample sample;
+    sample.name = name;
+    sample.rxSpeed = static_cast<qint64>(rxSpeed);
+    sample.txSpeed = static_cast<qint64>(txSpeed);
+    sample.time = QDateTime::currentMSecsSinceEpoch();
+    {
+        QMutexLocker lock(&m_statsMutex);
+        m_pendingStats.append(sample);
+    }
+    schedulePublish();
 }
 
 void GridDataManager::refreshData()
 {
+    // The previous result is still being placed; the next tick catches up
+    if(m_refreshInProgress.loadAcquire())
+    {
+        LOG_DEBUG("Grid", "Skipped refresh, %1 result(s) still in flight", m_refreshInProgress.loadRelaxed());
+        return;
+    }
     m_parser->parse();
 }
 
-void GridDataManager::swapCellsImpl(const QPoint& from, const QPoint& to)
+void GridDataManager::swapCellsImpl(const CellHandle& from, const CellHandle& to)
 {
-    if(from.x() < 0 || from.x() >= getRows() || from.y() < 0 || from.y() >= getCols() ||
-        to.x() < 0 || to.x() >= getRows() || to.y() < 0 || to.y() >= getCols())
+    QMutexLocker lock(&m_dataMutex);
+    if(!isCurrent(from) || !isCurrent(to))
     {
-        Logger::instance().log(Logger::Warning, "Invalid swap coordinates", "Grid");
+        LOG_DEBUG("Grid", "Dropped swap of reassigned cells %1 -> %2", from.slot, to.slot);
         return;
     }
+    if(from.slot == to.slot)
+        return;
 
-    std::swap(m_data[from.x()][from.y()], m_data[to.x()][to.y()]);
-    updateMacMap();
-
-    emit cellChanged(from);
-    emit cellChanged(to);
+    CellSlot& a = m_slots[from.slot];
+    CellSlot& b = m_slots[to.slot];
+    std::swap(a, b);
+    a.generation = nextGeneration();
+    b.generation = nextGeneration();
+    syncModel(a, from.slot / m_cols);
+    syncModel(b, to.slot / m_cols);
+    if(a.info)
+        m_nameIndex.insert(a.info->getName(), from.slot);
+    if(b.info)
+        m_nameIndex.insert(b.info->getName(), to.slot);
+
+    const QPoint fromPos = slotPosition(from.slot);
+    const QPoint toPos = slotPosition(to.slot);
+    lock.unlock();
+
+    emit cellChanged(fromPos);
+    emit cellChanged(toPos);
+    publishSnapshot();
 }
 
-void GridDataManager::handleParsingCompletedImpl(QVariant result)
+// Runs on the pool: only orders the fresh parse, the grid itself is
+// updated on the GUI thread in applyParsedInfos().
+QList<NetworkInfo*> GridDataManager::handleParsingCompletedImpl(const std::shared_ptr<INetworkSortStrategy>& sorter,
+                                                                QVariant result)
 {
     QList<NetworkInfo*> allInfos = result.value<QList<NetworkInfo*>>();
-    m_sorter->sort(allInfos);
-
-    const int rows = getRows();
-    const int cols = getCols();
-    const int capacity = rows * cols;
+    sorter->sort(allInfos);
+    return allInfos;
+}
 
-    QList<NetworkInfo*> usedInfos = allInfos.mid(0, capacity);
-    QList<NetworkInfo*> unusedInfos = allInfos.mid(capacity);
+void GridDataManager::applyParsedInfos(const QList<NetworkInfo*>& infos)
+{
+    if(m_cols <= 0)
+    {
+        qDeleteAll(infos);
+        return;
+    }
 
-    qDeleteAll(unusedInfos);
-    unusedInfos.clear();
+    const int oldRows = m_rows;
+    QList<QPoint> changedCells;
 
-    QHash<QString, QPoint> oldIndex = m_macIndex;
-    m_macIndex.clear();
+    QMutexLocker lock(&m_dataMutex);
 
-    for (int r = 0; r < rows; ++r)
+    // Find the current slot of every interface so it can be placed anywhere
+    const QVector<CellSlot> oldSlots = std::move(m_slots);
+    QHash<QString, int> previous;
+    previous.reserve(m_nameIndex.size());
+    QStringList layout;
+    layout.reserve(oldSlots.size());
+    for(int i = 0; i < oldSlots.size(); ++i)
     {
-        for (int c = 0; c < cols; ++c)
+        layout.append(oldSlots[i].info ? oldSlots[i].info->getName() : QString());
+        if(!oldSlots[i].info)
+            continue;
+
+        const QString& name = layout.last();
+        auto it = previous.find(name);
+        if(it != previous.end())
         {
-            const int linearIndex = r * cols + c;
-            NetworkInfo* info = (linearIndex < usedInfos.size()) ? usedInfos[linearIndex] : nullptr;
+            CellSlot duplicate = oldSlots[it.value()];
+            releaseSlot(duplicate);
+        }
+        previous.insert(name, i);
+    }
 
-            if (info)
-            {
-                const QString mac = info->getMac();
-
-                if (oldIndex.contains(mac))
-                {
-                    QPoint oldPos = oldIndex[mac];
-                    if (oldPos != QPoint(r, c))
-                    {
-                        std::swap(m_data[r][c], m_data[oldPos.x()][oldPos.y()]);
-                        emit cellChanged(oldPos);
-                    }
-                    m_data[r][c]->updateFromNetworkInfo(info);
-                }
-                else
-                {
-                    delete m_data[r][c];
-                    auto* model = new NetworkInfoModel(info, this);
-                    //model->moveToThread(this->thread());
-                    m_data[r][c] = model;
-                    m_macIndex[info->getMac()] = QPoint(r, c);
-                    emit cellChanged(QPoint(r, c));
-
-                    // m_scheduler->scheduleMainThread("model_creation",
-                    //                                 [this, r, c, info]()
-                    //                                 {
-                    //                                     delete m_data[r][c];
-                    //                                     m_data[r][c] = new NetworkInfoModel(info, nullptr);
-                    //                                     m_macIndex[info->getMac()] = QPoint(r, c);
-                    //                                     emit cellChanged(QPoint(r, c));
-                    //                                 },
-                    //                                 QThread::HighPriority
-                    //                                 );
-                }
-                m_macIndex[mac] = QPoint(r, c);
-            }
-            else if (m_data[r][c])
-            {
-                // Schedule cleanup in main thread
-                m_scheduler->scheduleMainThread(
-                    "model_cleanup",
-                    [=] {
-                        delete m_data[r][c];
-                        m_data[r][c] = nullptr;
-                        emit cellChanged({r,c});
-                    }
-                    );
-            }
+    QStringList ranked;
+    ranked.reserve(infos.size());
+    for(NetworkInfo* info : infos)
+    {
+        ranked.append(info->getName());
+    }
+    const GridPlacement::Result placement = m_placement.place(layout, ranked, m_pinnedNames,
+                                                              m_cols, m_minRows);
+    const int rows = placement.rows;
+
+    m_slots = QVector<CellSlot>(rows * m_cols);
+    m_rows = rows;
+    m_nameIndex.clear();
+    QVector<bool> occupied(m_slots.size(), false);
+
+    // A slot keeps its generation only if it still holds the same interface
+    for(int i = 0; i < infos.size(); ++i)
+    {
+        NetworkInfo* info = infos[i];
+        const QString& name = ranked[i];
+        const int target = placement.slots[i];
+
+        CellSlot slot;
+        auto it = previous.find(name);
+        if(it != previous.end())
+        {
+            slot = oldSlots[it.value()];
+            if(it.value() != target)
+                slot.generation = nextGeneration();
+            previous.erase(it);
+            slot.info->updateFrom(info);
+            delete info;
+        }
+        else
+        {
+            slot.info = info;
+            slot.generation = nextGeneration();
         }
+
+        syncModel(slot, target / m_cols);
+        m_slots[target] = slot;
+        occupied[target] = true;
+        m_nameIndex.insert(name, target);
+    }
+    for(int i = 0; i < m_slots.size(); ++i)
+    {
+        if(occupied[i])
+            continue;
+        const bool wasEmpty = i < oldSlots.size() && !oldSlots[i].info;
+        m_slots[i].generation = wasEmpty ? oldSlots[i].generation : nextGeneration();
+    }
+
+    // Interfaces that disappeared; views may still hold the models until
+    // the next UI frame, hence deleteLater
+    for(int i : std::as_const(previous))
+    {
+        CellSlot gone = oldSlots[i];
+        releaseSlot(gone);
     }
 
-    // Cleanup remaining old entries
-    for (auto it = oldIndex.constBegin(); it != oldIndex.constEnd(); ++it)
+    for(int i = 0; i < qMax(m_slots.size(), oldSlots.size()); ++i)
     {
-        const QPoint pos = it.value();
-        if (!m_macIndex.contains(it.key()) && m_data[pos.x()][pos.y()])
+        if(!isRowVisible(i / m_cols))
+            continue;
+        const CellSlot empty;
+        const CellSlot& before = i < oldSlots.size() ? oldSlots[i] : empty;
+        const CellSlot& after = i < m_slots.size() ? m_slots[i] : empty;
+        if(before.info != after.info || before.model != after.model)
         {
-            m_scheduler->scheduleMainThread("legacy_cleanup",
-                                            [this, pos]() {
-                                                delete m_data[pos.x()][pos.y()];
-                                                m_data[pos.x()][pos.y()] = nullptr;
-                                                emit cellChanged(pos);
-                                            },
-                                            QThread::NormalPriority
-                                            );
+            changedCells.append(slotPosition(i));
         }
     }
+    lock.unlock();
+
+    if(placement.reordered)
+    {
+        LOG_DEBUG("Grid", "Ranking changed significantly, %1 interfaces laid out again", infos.size());
+    }
+
+    const MemoryStats memory = memoryStats();
+    if(memory.interfaces != m_loggedInterfaceCount || memory.models != m_loggedModelCount)
+    {
+        m_loggedInterfaceCount = memory.interfaces;
+        m_loggedModelCount = memory.models;
+        LOG_DEBUG("Grid", "Grid memory: %1 interfaces, %2 models (%3 pooled, %4 created, %5 reused), "
+                  "~%6 bytes per interface (~%7 with a model each), RSS %8 KiB",
+                  memory.interfaces, memory.models, memory.pooledModels, memory.modelsCreated,
+                  memory.modelsReused, memory.bytes / qMax(1, memory.interfaces),
+                  memory.eagerBytes / qMax(1, memory.interfaces), memory.residentBytes / 1024);
+    }
+    if(rows != oldRows)
+    {
+        emit gridDimensionsChanged();
+    }
+    for(const QPoint& pos : changedCells)
+    {
+        emit cellChanged(pos);
+    }
+    publishSnapshot();
+}
+
+// GUI thread only. Hidden interfaces have no model; the model, if any,
+// picks the change up from NetworkInfo's signals.
+void GridDataManager::applyPendingStats()
+{
+    QVector<StatsSample> samples;
+    {
+        QMutexLocker lock(&m_statsMutex);
+        samples.swap(m_pendingStats);
+    }
+    if(samples.isEmpty())
+        return;
+
+    QMutexLocker lock(&m_dataMutex);
+    for(const StatsSample& sample : std::as_const(samples))
+    {
+        auto it = m_nameIndex.constFind(sample.name);
+        if(it == m_nameIndex.constEnd())
+            continue;
+
+        NetworkInfo* info = m_slots[it.value()].info;
+        info->setRxSpeed(sample.rxSpeed);
+        info->setTxSpeed(sample.txSpeed);
+        info->setLastUpdateTime(sample.time);
+        info->speedHistory().append(sample.rxSpeed, sample.txSpeed);
+    }
+}
+
+int GridDataManager::slotIndex(const QPoint& indx) const
+{
+    if(indx.x() < 0 || indx.x() >= m_rows || indx.y() < 0 || indx.y() >= m_cols)
+        return -1;
+    return indx.x() * m_cols + indx.y();
+}
+
+QPoint GridDataManager::slotPosition(int slot) const
+{
+    return QPoint(slot / m_cols, slot % m_cols);
+}
+
+bool GridDataManager::isCurrent(const CellHandle& handle) const
+{
+    return handle.slot >= 0 && handle.slot < m_slots.size() &&
+           m_slots[handle.slot].generation == handle.generation;
+}
+
+// Never 0, so a default CellHandle is never current
+quint32 GridDataManager::nextGeneration()
+{
+    if(++m_generation == 0)
+        ++m_generation;
+    return m_generation;
+}
 
-    //qDeleteAll(usedInfos);
+bool GridDataManager::isRowVisible(int row) const
+{
+    return row >= m_firstVisibleRow && row < m_firstVisibleRow + m_visibleRowCount;
+}
 
-    // // Clear temporary lists after scheduling all tasks
-    // QMetaObject::invokeMethod(this, [usedInfos]() {
-    //     qDeleteAll(usedInfos);
-    // }, Qt::QueuedConnection);
+// Only ever releases; cellData() creates models on demand
+void GridDataManager::syncModel(CellSlot& slot, int row)
+{
+    if(slot.model && !(slot.info && isRowVisible(row)))
+    {
+        recycleModel(slot.model);
+        slot.model = nullptr;
+    }
 }
 
-void GridDataManager::handleNetworkStatsImpl(const QString& mac, const quint64& rxSpeed, const quint64& txSpeed)
+void GridDataManager::releaseSlot(CellSlot& slot)
 {
-    if(m_macIndex.contains(mac))
+    if(slot.model)
+    {
+        recycleModel(slot.model);
+        slot.model = nullptr;
+    }
+    if(slot.info)
     {
-        NetworkInfoModel* model = m_data[m_macIndex[mac].x()][m_macIndex[mac].y()];
-        model->updateSpeeds(rxSpeed, txSpeed);
+        slot.info->deleteLater();
+        slot.info = nullptr;
     }
 }
 
 void GridDataManager::clearGrid()
 {
-    for(auto& row : m_data)
+    for(CellSlot& slot : m_slots)
     {
-        qDeleteAll(row);
-        row.clear();
+        delete slot.model;
+        delete slot.info;
     }
-    m_data.clear();
-    m_macIndex.clear();
+    qDeleteAll(m_modelPool);
+    m_modelPool.clear();
+    m_slots.clear();
+    m_nameIndex.clear();
+    m_rows = 0;
 }
 
-void GridDataManager::updateMacMap()
+NetworkInfoModel* GridDataManager::acquireModel(NetworkInfo* info)
 {
-    m_macIndex.clear();
-    for (int r = 0; r < m_data.size(); ++r)
+    if(m_modelPool.isEmpty())
     {
-        for (int c = 0; c < m_data[r].size(); ++c)
+        ++m_modelsCreated;
+        return new NetworkInfoModel(info, this);
+    }
+
+    ++m_modelsReused;
+    NetworkInfoModel* model = m_modelPool.takeLast();
+    model->rebind(info);
+    return model;
+}
+
+// Views may still hold the model until the next UI frame, so it is
+// detached from its interface rather than deleted right away
+void GridDataManager::recycleModel(NetworkInfoModel* model)
+{
+    model->rebind(nullptr);
+    model->takeChangedFields();
+    if(m_modelPool.size() < MODEL_POOL_MAX)
+    {
+        m_modelPool.append(model);
+    }
+    else
+    {
+        model->deleteLater();
+    }
+}
+
+// Shallow sizes plus the interface's string payloads; QObject private data
+// and signal connections are not included
+GridDataManager::MemoryStats GridDataManager::memoryStats() const
+{
+    QMutexLocker lock(&m_dataMutex);
+    MemoryStats stats;
+    stats.pooledModels = m_modelPool.size();
+    stats.modelsCreated = m_modelsCreated;
+    stats.modelsReused = m_modelsReused;
+    stats.bytes = m_slots.capacity() * qint64(sizeof(CellSlot)) +
+                  m_nameIndex.size() * qint64(sizeof(QString) + sizeof(int)) +
+                  stats.pooledModels * qint64(sizeof(NetworkInfoModel));
+    for(const CellSlot& slot : m_slots)
+    {
+        if(slot.info)
         {
-            if (m_data[r][c] && !m_data[r][c]->getMac().isEmpty())
-            {
-                m_macIndex.insert(m_data[r][c]->getMac(), QPoint(r, c));
-            }
+            ++stats.interfaces;
+            stats.bytes += sizeof(NetworkInfo) + sizeof(char16_t) *
+                           (slot.info->getName().size() + slot.info->getMac().size() +
+                            slot.info->getIpv4().size() + slot.info->getNetmask().size() +
+                            slot.info->getBroadcast().size());
+        }
+        if(slot.model)
+        {
+            ++stats.models;
+            stats.bytes += sizeof(NetworkInfoModel);
         }
     }
+
+    // The baseline before lazy models: every interface had a model, each
+    // with its own copy of the label map, and nothing was pooled
+    qint64 labelBytes = 0;
+    const QHash<QString, QString>& labels = NetworkInfoModel::propertyMap();
+    for(auto it = labels.cbegin(); it != labels.cend(); ++it)
+    {
+        labelBytes += 2 * qint64(sizeof(QString)) + sizeof(char16_t) * (it.key().size() + it.value().size());
+    }
+    stats.eagerBytes = stats.bytes - (stats.models + stats.pooledModels) * qint64(sizeof(NetworkInfoModel)) +
+                       stats.interfaces * (qint64(sizeof(NetworkInfoModel)) + labelBytes);
+    stats.residentBytes = residentSetBytes();
+    return stats;
+}
+
+// GUI thread only, so there is a single writer. The previous snapshot is
+// freed by whichever reader drops the last reference to it.
+void GridDataManager::publishSnapshot()
+{
+    m_publishPending.storeRelaxed(0);
+    applyPendingStats();
+
+    auto next = std::make_shared<Snapshot>();
+    {
+        QMutexLocker lock(&m_dataMutex);
+        next->version = snapshot()->version + 1;
+        next->rows = m_rows;
+        next->cols = m_cols;
+        next->interfaces.reserve(m_nameIndex.size());
+        for(int i = 0; i < m_slots.size(); ++i)
+        {
+            const NetworkInfo* info = m_slots[i].info;
+            if(!info)
+                continue;
+
+            InterfaceSummary summary;
+            summary.index = slotPosition(i);
+            summary.name = info->getName();
+            summary.rxSpeed = info->getRxSpeed();
+            summary.txSpeed = info->getTxSpeed();
+            summary.isUp = info->getIsUp();
+            next->nameIndex.insert(info->getName(), next->interfaces.size());
+            next->interfaces.append(summary);
+        }
+    }
+
+    m_snapshot.store(std::move(next), std::memory_order_release);
+    emit interfacesChanged();
+}
+
+// Stats arrive per interface from the pool; they are applied and folded
+// into one snapshot on the next GUI thread pass instead of one each.
+void GridDataManager::schedulePublish()
+{
+    if(!m_publishPending.testAndSetOrdered(0, 1))
+        return;
+
+    m_scheduler->scheduleMainThread(QString("grid_publish"),
+                                    [this]
+                                    {
+                                        publishSnapshot();
+                                    });
 }
@@ -4,33 +4,135 @@
 #include <QObject>
 #include <QVector>
 #include <QHash>
+#include <QSet>
 #include <QNetworkInterface>
 #include <QPoint>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QAtomicInt>
+#include <atomic>
+#include <memory>
 
 #include "../Utilities/Parser/iparser.h"
+#include "../TaskSystem/Coroutines/cotask.h"
+#include "gridplacement.h"
 
+class NetworkInfo;
 class NetworkInfoModel;
 class IParser;
 class INetworkSortStrategy;
 class NetworkMonitor;
 class TaskScheduler;
 
+// Holds every parsed interface in one flat row-major slot array over
+// getCols() columns; the grid grows past the configured row count when
+// there are more interfaces than fit. A NetworkInfoModel only exists for
+// cells inside the visible row range that a view has bound, everything
+// else is kept as bare NetworkInfo; released models are recycled.
+//
+// Every slot carries a generation that changes whenever its content is
+// reassigned, so a CellHandle taken earlier can tell that the interface it
+// pointed at has moved. Interfaces are identified by name: MACs repeat
+// (bridges and their ports, VLANs, bond slaves) or are missing (tun, wg,
+// ppp), names are unique per host. The name index maps straight to slots
+// and is kept up to date on every change instead of being rebuilt.
+//
+// The grid and its NetworkInfos are only written on the GUI thread, under
+// m_dataMutex; stats from the pool are queued and applied there. Everything
+// outside the GUI thread reads published Snapshots instead: the GUI thread
+// rebuilds one after every change and swaps it in atomically, readers keep
+// whichever one they loaded for as long as they hold it. Note that
+// std::atomic<std::shared_ptr> is not lock-free in libstdc++: load() and
+// store() take a short internal spinlock around the pointer swap, which
+// never contends with m_dataMutex.
 class GridDataManager : public QObject
 {
     Q_OBJECT
 public:
+    // Per-interface values for overview rendering, in grid order
+    struct InterfaceSummary
+    {
+        QPoint index;
+        QString name;
+        qint64 rxSpeed = 0;
+        qint64 txSpeed = 0;
+        bool isUp = false;
+    };
+
+    // Immutable once published
+    struct Snapshot
+    {
+        quint64 version = 0;
+        int rows = 0;
+        int cols = 0;
+        QVector<InterfaceSummary> interfaces;// grid order
+        QHash<QString, int> nameIndex;// interface name -> interfaces
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    struct MemoryStats
+    {
+        int interfaces = 0;
+        int models = 0;
+        int pooledModels = 0;
+        quint64 modelsCreated = 0;
+        quint64 modelsReused = 0;
+        qint64 bytes = 0;// approximate
+        qint64 eagerBytes = 0;// same accounting with one model per interface
+        qint64 residentBytes = 0;// process RSS, 0 where unknown
+    };
+
+    struct CellHandle
+    {
+        int slot = -1;
+        quint32 generation = 0;
+    };
+
     explicit GridDataManager(TaskScheduler* scheduler, QObject* parent = nullptr);
     virtual ~GridDataManager();
-    NetworkInfoModel* cellData(QPoint indx) const;
+    // GUI thread: creates the model of a visible cell on first use
+    NetworkInfoModel* cellData(QPoint indx);
+    // GUI thread: the handle goes stale once the cell is swapped or re-parsed
+    CellHandle cellHandle(const QPoint& indx) const;
+    QPoint cellPosition(const CellHandle& handle) const;// (-1, -1) when stale
 
     int getRows() const;
     int getCols() const;
+    int interfaceCount() const;
+    int getViewportRows() const;
+    // Any thread, never blocks on m_dataMutex
+    SnapshotPtr snapshot() const;
+    QVector<InterfaceSummary> interfaceSummaries() const;
+    MemoryStats memoryStats() const;
+    // GUI thread: a model for one cell regardless of the visible window.
+    // It is deleted together with the interface, or by releaseDetachedModel()
+    // which unbinds it first so no stats update can reach it afterwards.
+    NetworkInfoModel* createDetachedModel(const QPoint& indx);
+    void releaseDetachedModel(NetworkInfoModel* model);
     void initializeGrid(int rows, int cols);
+    // GUI thread: changes the viewport rows and the columns in place. Models
+    // and pins survive and the interfaces are re-placed without a re-parse.
+    void resizeGrid(int rows, int cols);
     void swapCells(const QPoint& from, const QPoint& to);
 
+    // GUI thread: a pinned interface keeps its cell across re-parses; the
+    // pin follows the interface when it is swapped by hand
+    void setCellPinned(const QPoint& indx, bool pinned);
+    bool isCellPinned(const QPoint& indx) const;
+    // Rank shift an interface may have before a re-parse reorders the grid
+    void setReorderTolerance(int positions);
+
+    // GUI thread: creates models for the given rows and releases the rest
+    void setVisibleRows(int firstRow, int rowCount);
+
+    // GUI thread: periods of the interface re-parse and the stats sampling
+    void setSamplingIntervals(int refreshMs, int statsMs);
+    void sampleNow();
+
+    static constexpr int REFRESH_INTERVAL_DEFAULT = 2000;
+    static constexpr int STATS_INTERVAL_DEFAULT = 1000;
+    static constexpr int MODEL_POOL_MAX = 64;
+
 signals:
     //void modelChanged();
     void gridDimensionsChanged();
@@ -38,30 +140,78 @@ signals:
     void networkHighlightChanged(int row, int col);
 
     void cellChanged(QPoint indx);
+    // A new snapshot was published; emitted on the GUI thread
+    void interfacesChanged();
     void gridReset();
 
 private slots:
     void handleParsingCompleted(const QVariant& result);
-    void handleNetworkStats(const QString& mac, const quint64& rxSpeed, const quint64& txSpeed);
+    void handleNetworkStats(const QString& name, quint64 rxSpeed, quint64 txSpeed);
     void refreshData();
 
-    void swapCellsImpl(const QPoint& from, const QPoint& to);
-    void handleParsingCompletedImpl(QVariant result);
-    void handleNetworkStatsImpl(const QString& mac, const quint64& rxSpeed, const quint64& txSpeed);
+    void swapCellsImpl(const CellHandle& from, const CellHandle& to);
+    void applyParsedInfos(const QList<NetworkInfo*>& infos);
 
 private:
+    struct CellSlot
+    {
+        NetworkInfo* info = nullptr;
+        NetworkInfoModel* model = nullptr;
+        quint32 generation = 0;
+    };
+
+    struct StatsSample
+    {
+        QString name;
+        qint64 rxSpeed = 0;
+        qint64 txSpeed = 0;
+        qint64 time = 0;
+    };
+
+    CoTask processParsingResult(QVariant result);
+    static QList<NetworkInfo*> handleParsingCompletedImpl(const std::shared_ptr<INetworkSortStrategy>& sorter,
+                                                          QVariant result);
+    int slotIndex(const QPoint& indx) const;
+    QPoint slotPosition(int slot) const;
+    bool isCurrent(const CellHandle& handle) const;
+    quint32 nextGeneration();
+    bool isRowVisible(int row) const;
+    void syncModel(CellSlot& slot, int row);
+    void releaseSlot(CellSlot& slot);
+    NetworkInfoModel* acquireModel(NetworkInfo* info);
+    void recycleModel(NetworkInfoModel* model);
     void processDataAsync();
     void safeSwapCells(QPoint from, QPoint to);
     void clearGrid();
-    void updateMacMap();//TODO: mb remove later
+    void applyPendingStats();
+    void publishSnapshot();
+    void schedulePublish();
 
     TaskScheduler* m_scheduler;
     QAtomicInt m_refreshInProgress{0};
     NetworkMonitor* m_monitor;
     std::shared_ptr<IParser> m_parser;
     std::shared_ptr<INetworkSortStrategy> m_sorter;
-    QVector<QVector<NetworkInfoModel*>> m_data;
-    QHash<QString, QPoint> m_macIndex;
+    mutable QMutex m_dataMutex;
+    QVector<CellSlot> m_slots;// row-major, m_rows * m_cols
+    QHash<QString, int> m_nameIndex;// interface name -> slot
+    QSet<QString> m_pinnedNames;
+    QVector<NetworkInfoModel*> m_modelPool;
+    quint64 m_modelsCreated = 0;
+    quint64 m_modelsReused = 0;
+    int m_loggedInterfaceCount = -1;
+    int m_loggedModelCount = -1;
+    GridPlacement m_placement;
+    quint32 m_generation = 0;
+    QMutex m_statsMutex;
+    QVector<StatsSample> m_pendingStats;// pool -> GUI, in arrival order
+    std::atomic<SnapshotPtr> m_snapshot;
+    QAtomicInt m_publishPending{0};
+    int m_rows = 0;
+    int m_minRows = 0;
+    int m_cols = 0;
+    int m_firstVisibleRow = 0;
+    int m_visibleRowCount = 0;
 };
 
 #endif // GRIDDATAMANAGER_H
@@ -1,23 +1,50 @@
 #include "gridmanager.h"
 #include "../../../UI/Components/Grid/GridViewManager/gridviewmanager.h"
+#include "../../../UI/Components/Grid/GridCanvasView/gridcanvasview.h"
+#include "../../../UI/Components/Grid/GridHeatmapView/gridheatmapview.h"
+#include "../../../UI/Components/Grid/GridCellWidgets/networkinfoviewwidget.h"
 #include "griddatamanager.h"
+#include "uiupdatecoalescer.h"
+#include "../../Network/Information/networkinfomodel.h"
 #include "../Utilities/Logger/logger.h"
 #include "../TaskSystem/taskscheduler.h"
+#include "../Utilities/Animation/animationclock.h"
+
+#include <QStackedWidget>
+#include <QMenu>
+#include <QTimer>
+#include <QEvent>
+#include <QtMath>
 
 GridManager::GridManager(QObject* parent)
     :m_scheduler(new TaskScheduler(this)),
     m_dataManager(new GridDataManager(m_scheduler, this)),
-    m_viewManager(new GridViewManager()),
+    m_uiCoalescer(new UiUpdateCoalescer(this)),
+    m_viewHost(new QStackedWidget()),
+    m_viewManager(new GridViewManager(m_viewHost.data())),
+    m_canvasView(new GridCanvasView(m_viewHost.data())),
+    m_heatmapView(new GridHeatmapView(m_viewHost.data())),
+    m_autoLayoutTimer(new QTimer(this)),
     QObject(parent)
 {
+    // Window resizes arrive in bursts; lay out once they settle
+    m_autoLayoutTimer->setSingleShot(true);
+    m_autoLayoutTimer->setInterval(AUTO_LAYOUT_DELAY_MS);
+    connect(m_autoLayoutTimer, &QTimer::timeout, this, &GridManager::applyAutoLayout);
+    m_viewHost->installEventFilter(this);
+
+    m_viewHost->addWidget(m_viewManager);
+    m_viewHost->addWidget(m_canvasView);
+    m_viewHost->addWidget(m_heatmapView);
+    m_scheduler->setSchedulingMode(TaskScheduler::EarliestDeadlineFirst);
     setupConnections();
     setupGridManager();
-    Logger::instance().log(Logger::Info, "GridManager initialized", "Grid");
+    LOG_INFO("Grid", "GridManager initialized");
 }
 
 GridManager::~GridManager()
 {
-
+    m_viewHost->removeEventFilter(this);
 }
 
 int GridManager::getRows() const
@@ -32,12 +59,147 @@ int GridManager::getCols() const
 
 void GridManager::setGridDimensions(int rows, int cols)
 {
-    m_dataManager->initializeGrid(rows, cols);
+    m_dataManager->resizeGrid(rows, cols);
+}
+
+bool GridManager::autoLayout() const
+{
+    return m_autoLayout;
+}
+
+void GridManager::setAutoLayout(bool enabled)
+{
+    if(m_autoLayout == enabled)
+        return;
+
+    m_autoLayout = enabled;
+    m_autoLayoutCount = -1;
+    if(enabled)
+    {
+        applyAutoLayout();
+    }
+    else
+    {
+        m_autoLayoutTimer->stop();
+    }
+}
+
+int GridManager::currentPage() const
+{
+    return m_page;
+}
+
+int GridManager::pageCount() const
+{
+    return m_pageCount;
+}
+
+void GridManager::setPage(int page)
+{
+    const int pageRows = qMax(1, m_dataManager->getViewportRows());
+    const int row = qBound(0, page, m_pageCount - 1) * pageRows;
+    if(m_renderMode == WidgetRendering)
+    {
+        m_viewManager->scrollToRow(row);
+    }
+    else if(m_renderMode == CanvasRendering)
+    {
+        m_canvasView->scrollToRow(row);
+    }
+}
+
+void GridManager::nextPage()
+{
+    setPage(m_page + 1);
+}
+
+void GridManager::previousPage()
+{
+    setPage(m_page - 1);
+}
+
+bool GridManager::eventFilter(QObject* watched, QEvent* event)
+{
+    if(watched == m_viewHost.data() && event->type() == QEvent::Resize && m_autoLayout)
+    {
+        m_autoLayoutTimer->start();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+GridManager::RenderMode GridManager::renderMode() const
+{
+    return m_renderMode;
+}
+
+void GridManager::setRenderMode(RenderMode mode)
+{
+    if(m_renderMode == mode)
+        return;
+
+    m_renderMode = mode;
+    resetViews();
+    switch(mode)
+    {
+    case CanvasRendering:
+        m_viewHost->setCurrentWidget(m_canvasView);
+        break;
+    case HeatmapRendering:
+        m_viewHost->setCurrentWidget(m_heatmapView);
+        break;
+    default:
+        m_viewHost->setCurrentWidget(m_viewManager);
+        break;
+    }
+    emit renderModeChanged(mode);
+}
+
+GridManager::PowerMode GridManager::powerMode() const
+{
+    return m_powerMode;
+}
+
+// Background pauses the frame coalescer and the animation clock outright
+// and stretches sampling; going back to a visible mode samples at once
+// and flushes everything that piled up in a single frame.
+void GridManager::setPowerMode(PowerMode mode)
+{
+    if(m_powerMode == mode)
+        return;
+
+    const PowerMode previous = m_powerMode;
+    m_powerMode = mode;
+    AnimationClock& clock = AnimationClock::instance();
+
+    if(mode == Background)
+    {
+        m_uiCoalescer->setPaused(true);
+        clock.setPaused(true);
+        m_dataManager->setSamplingIntervals(BACKGROUND_REFRESH_INTERVAL_MS, BACKGROUND_STATS_INTERVAL_MS);
+    }
+    else
+    {
+        m_uiCoalescer->setMaxFrameRate(mode == Interactive ? UiUpdateCoalescer::DEFAULT_FRAME_RATE
+                                                           : UNFOCUSED_FRAME_RATE);
+        clock.setInterval(mode == Interactive ? AnimationClock::DEFAULT_INTERVAL_MS
+                                              : UNFOCUSED_ANIMATION_INTERVAL_MS);
+        m_dataManager->setSamplingIntervals(GridDataManager::REFRESH_INTERVAL_DEFAULT,
+                                            GridDataManager::STATS_INTERVAL_DEFAULT);
+        if(previous == Background)
+        {
+            m_dataManager->sampleNow();
+            clock.setPaused(false);
+            m_uiCoalescer->setPaused(false);
+        }
+    }
+
+    LOG_INFO("Power", "Power mode %1 -> %2", previous, mode);
+    emit powerModeChanged(mode);
 }
 
 void GridManager::initializeView()
 {
-    m_viewManager->setGridSize(getRows(), getCols());
+    resetViews();
 }
 
 void GridManager::initializeData()
@@ -54,31 +216,234 @@ void GridManager::setupGridManager()
 
 void GridManager::setupConnections()
 {
+    // Cells only change on the GUI thread; the coalescer batches them into
+    // one pass per frame. It keeps its lock for the marks that stay
+    // any-thread (snapshots, and models through their property signals).
     connect(m_dataManager, &GridDataManager::cellChanged,
-            this, [=](QPoint indx)
+            m_uiCoalescer, &UiUpdateCoalescer::markCellDirty);
+    connect(m_uiCoalescer, &UiUpdateCoalescer::frameReady,
+            this, &GridManager::applyUiFrame);
+
+    // The heatmap reads a fresh snapshot at most once per frame
+    connect(m_dataManager, &GridDataManager::interfacesChanged,
+            m_uiCoalescer, &UiUpdateCoalescer::markSnapshotDirty, Qt::DirectConnection);
+    connect(m_uiCoalescer, &UiUpdateCoalescer::snapshotFrameReady,
+            this, [this]()
+            {
+                if(m_renderMode == HeatmapRendering)
+                    refreshHeatmap();
+            });
+    connect(m_dataManager, &GridDataManager::interfacesChanged,
+            this, [this]()
             {
-                m_scheduler->scheduleMainThread(
-                    "ui_update",
-                    [=]
-                    {
-                        m_viewManager->updateCell(indx.x(), indx.y(), m_dataManager->cellData(indx));
-                    },
-                    QThread::HighPriority
-                );
+                if(m_autoLayout && m_dataManager->interfaceCount() != m_autoLayoutCount)
+                    m_autoLayoutTimer->start();
             });
+    connect(m_heatmapView, &GridHeatmapView::tileActivated,
+            this, &GridManager::openInterfaceDetails);
+    connect(m_viewManager, &GridViewManager::cellContextMenuRequested,
+            this, &GridManager::showCellMenu);
+    connect(m_canvasView, &GridCanvasView::cellContextMenuRequested,
+            this, &GridManager::showCellMenu);
 
     connect(m_dataManager, &GridDataManager::gridDimensionsChanged,
-            m_viewManager.get(), [this]()
+            this, &GridManager::resetViews);
+
+    connect(m_viewManager, &GridViewManager::cellSwapRequestToDataManager,
+            m_dataManager, &GridDataManager::swapCells);
+    connect(m_canvasView, &GridCanvasView::cellSwapRequestToDataManager,
+            m_dataManager, &GridDataManager::swapCells);
+
+    // Only the active view's window decides which rows get models
+    connect(m_viewManager, &GridViewManager::visibleRowsChanged,
+            this, [this](int firstRow, int rowCount)
+            {
+                if(m_renderMode == WidgetRendering)
+                    handleVisibleRowsChanged(firstRow, rowCount);
+            });
+    connect(m_canvasView, &GridCanvasView::visibleRowsChanged,
+            this, [this](int firstRow, int rowCount)
             {
-                m_viewManager->setGridSize(m_dataManager->getRows(),
-                                           m_dataManager->getCols());
+                if(m_renderMode == CanvasRendering)
+                    handleVisibleRowsChanged(firstRow, rowCount);
             });
+}
 
-    connect(m_viewManager.get(), &GridViewManager::cellSwapRequestToDataManager,
-            m_dataManager, &GridDataManager::swapCells);
+void GridManager::updateViewCell(const QPoint& indx)
+{
+    if(m_renderMode == HeatmapRendering)
+        return;
+
+    NetworkInfoModel* model = m_dataManager->cellData(indx);
+    m_uiCoalescer->watchModel(model);
+
+    if(m_renderMode == CanvasRendering)
+    {
+        m_canvasView->updateCell(indx.x(), indx.y(), model);
+    }
+    else
+    {
+        m_viewManager->updateCell(indx.x(), indx.y(), model);
+    }
+}
+
+void GridManager::applyUiFrame(const QList<QPoint>& cells, const QList<NetworkInfoModel*>& models)
+{
+    // One event-loop pass; Qt merges the repaints of everything touched here
+    for(const QPoint& indx : cells)
+    {
+        updateViewCell(indx);
+    }
+    for(NetworkInfoModel* model : models)
+    {
+        model->publishChangedFields();
+    }
+}
+
+// Only the active view is bound to models; the other ones are kept empty
+// so they never hold on to models the data manager has already deleted.
+// The heatmap needs no models at all.
+void GridManager::resetViews()
+{
+    const int rows = m_dataManager->getRows();
+    const int cols = m_dataManager->getCols();
+    const int viewportRows = m_dataManager->getViewportRows();
+    const bool widgets = m_renderMode == WidgetRendering;
+    const bool canvas = m_renderMode == CanvasRendering;
+    m_viewManager->setGridSize(widgets ? rows : 0, widgets ? cols : 0, widgets ? viewportRows : 0);
+    m_canvasView->setGridSize(canvas ? rows : 0, canvas ? cols : 0, canvas ? viewportRows : 0);
+
+    if(widgets)
+    {
+        handleVisibleRowsChanged(m_viewManager->firstVisibleRow(), m_viewManager->visibleRowCount());
+    }
+    else if(canvas)
+    {
+        handleVisibleRowsChanged(m_canvasView->firstVisibleRow(), m_canvasView->visibleRowCount());
+    }
+    else
+    {
+        m_dataManager->setVisibleRows(0, 0);
+    }
+
+    if(m_renderMode == HeatmapRendering)
+    {
+        refreshHeatmap();
+    }
+    else
+    {
+        m_heatmapView->clear();
+    }
+}
+
+// Models follow the active view's window; the cells in it are rebound
+// right away so a scrolled-in row never shows the previous row's data.
+void GridManager::handleVisibleRowsChanged(int firstRow, int rowCount)
+{
+    m_dataManager->setVisibleRows(firstRow, rowCount);
+    updatePage(firstRow);
+
+    const int lastRow = qMin(firstRow + rowCount, m_dataManager->getRows());
+    const int cols = m_dataManager->getCols();
+    for(int row = firstRow; row < lastRow; ++row)
+    {
+        for(int col = 0; col < cols; ++col)
+        {
+            updateViewCell(QPoint(row, col));
+        }
+    }
+}
+
+// Columns as square as the interface count allows, capped by what fits the
+// width; as many rows as fit the height. The rest spills onto pages and
+// stays sampled by the data manager without models or widgets.
+void GridManager::applyAutoLayout()
+{
+    if(!m_autoLayout)
+        return;
+
+    const int count = m_dataManager->interfaceCount();
+    m_autoLayoutCount = count;
+    const QSize area = m_viewHost->size();
+    const int fitCols = qMax(1, area.width() / AUTO_CELL_WIDTH_MIN);
+    const int fitRows = qMax(1, area.height() / AUTO_CELL_HEIGHT_MIN);
+    const int cells = qMax(1, count);
+
+    const int cols = qBound(1, qMax((cells + fitRows - 1) / fitRows, int(qCeil(qSqrt(cells)))), fitCols);
+    const int rows = qBound(1, (cells + cols - 1) / cols, fitRows);
+    if(rows != m_dataManager->getViewportRows() || cols != m_dataManager->getCols())
+    {
+        LOG_DEBUG("Grid", "Auto layout: %1 interfaces -> %2x%3", count, rows, cols);
+        m_dataManager->resizeGrid(rows, cols);
+    }
+}
+
+void GridManager::updatePage(int firstRow)
+{
+    const int pageRows = qMax(1, m_dataManager->getViewportRows());
+    const int pageCount = qMax(1, (m_dataManager->getRows() + pageRows - 1) / pageRows);
+    const int page = qBound(0, (firstRow + pageRows - 1) / pageRows, pageCount - 1);
+    if(page == m_page && pageCount == m_pageCount)
+        return;
+
+    m_page = page;
+    m_pageCount = pageCount;
+    emit pageChanged(m_page, m_pageCount);
+}
+
+void GridManager::refreshHeatmap()
+{
+    m_heatmapView->setSummaries(m_dataManager->interfaceSummaries());
+}
+
+// The detail popup gets its own model, independent of the visible window;
+// it closes itself when the interface goes away.
+void GridManager::openInterfaceDetails(const QPoint& indx)
+{
+    NetworkInfoModel* model = m_dataManager->createDetachedModel(indx);
+    if(!model)
+        return;
+
+    NetworkInfoViewWidget* details = new NetworkInfoViewWidget(model);
+    details->setParent(m_viewHost.data(), Qt::Tool);
+    details->setAttribute(Qt::WA_DeleteOnClose);
+    details->setWindowTitle(model->fieldValue(NetworkInfoModel::NameField));
+    connect(details, &QObject::destroyed, model, [this, model]()
+            {
+                m_dataManager->releaseDetachedModel(model);
+            });
+    connect(model, &QObject::destroyed, details, &QWidget::close);
+
+    m_uiCoalescer->watchModel(model);
+    details->show();
+}
+
+void GridManager::showCellMenu(const QPoint& indx, const QPoint& globalPos)
+{
+    if(!m_dataManager->cellData(indx))
+        return;
+
+    QMenu menu;
+    QAction* pinAction = menu.addAction(tr("Pin Position"));
+    pinAction->setCheckable(true);
+    pinAction->setChecked(m_dataManager->isCellPinned(indx));
+    if(menu.exec(globalPos) == pinAction)
+    {
+        m_dataManager->setCellPinned(indx, pinAction->isChecked());
+    }
+}
+
+QWidget* GridManager::getView() const
+{
+    return m_viewHost.data();
+}
+
+TaskScheduler* GridManager::getScheduler() const
+{
+    return m_scheduler;
 }
 
-GridViewManager* GridManager::getView() const
+UiUpdateCoalescer* GridManager::getUiUpdateCoalescer() const
 {
-    return m_viewManager.data();
+    return m_uiCoalescer;
 }
@@ -2,9 +2,17 @@
 #define GRIDMANAGER_H
 
 #include <QObject>
+#include <QPoint>
 
+class QWidget;
+class QStackedWidget;
+class QTimer;
 class GridDataManager;
 class GridViewManager;
+class GridCanvasView;
+class GridHeatmapView;
+class UiUpdateCoalescer;
+class NetworkInfoModel;
 class IParser;
 class INetworkSortStrategy;
 class ParserType;
@@ -18,7 +26,24 @@ class GridManager : public QObject
     Q_OBJECT
     Q_PROPERTY(int rows READ getRows NOTIFY gridDimensionsChanged)
     Q_PROPERTY(int cols READ getCols NOTIFY gridDimensionsChanged)
+    Q_PROPERTY(int page READ currentPage WRITE setPage NOTIFY pageChanged)
 public:
+    enum RenderMode
+    {
+        WidgetRendering,    // one NetworkInfoViewWidget per cell
+        CanvasRendering,    // every cell painted by a single GridCanvasView
+        HeatmapRendering    // one coloured tile per interface, no models bound
+    };
+    Q_ENUM(RenderMode)
+
+    enum PowerMode
+    {
+        Interactive,    // visible and focused: full frame and sampling rate
+        Unfocused,      // visible, other window focused: lower frame rate
+        Background      // minimized, hidden or not exposed: no rendering, slow sampling
+    };
+    Q_ENUM(PowerMode)
+
     GridManager(QObject* parent = nullptr);
     virtual ~GridManager();
 
@@ -26,25 +51,78 @@ public:
     int getCols() const;
     void setGridDimensions(int rows, int cols);
 
-    GridViewManager* getView() const;
+    // Derives rows and columns from the interface count and the view size;
+    // interfaces that do not fit go to further pages
+    bool autoLayout() const;
+    void setAutoLayout(bool enabled);
+
+    // A page is one viewport of rows; flipping only rebinds the cells
+    int currentPage() const;
+    int pageCount() const;
+    void setPage(int page);
+    void nextPage();
+    void previousPage();
+
+    RenderMode renderMode() const;
+    void setRenderMode(RenderMode mode);
+
+    PowerMode powerMode() const;
+    void setPowerMode(PowerMode mode);
+
+    QWidget* getView() const;
+    TaskScheduler* getScheduler() const;
+    UiUpdateCoalescer* getUiUpdateCoalescer() const;
 
 signals:
     void gridDimensionsChanged();
+    void renderModeChanged(GridManager::RenderMode mode);
+    void powerModeChanged(GridManager::PowerMode mode);
+    void pageChanged(int page, int pageCount);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     void initializeView();
     void initializeData();
     void setupGridManager();
     void setupConnections();
+    void updateViewCell(const QPoint& indx);
+    void applyUiFrame(const QList<QPoint>& cells, const QList<NetworkInfoModel*>& models);
+    void resetViews();
+    void handleVisibleRowsChanged(int firstRow, int rowCount);
+    void refreshHeatmap();
+    void openInterfaceDetails(const QPoint& indx);
+    void showCellMenu(const QPoint& indx, const QPoint& globalPos);
+    void applyAutoLayout();
+    void updatePage(int firstRow);
 
     TaskScheduler* m_scheduler;
     GridDataManager* m_dataManager;
-    QScopedPointer<GridViewManager> m_viewManager;
+    UiUpdateCoalescer* m_uiCoalescer;
+    QScopedPointer<QStackedWidget> m_viewHost;
+    GridViewManager* m_viewManager;
+    GridCanvasView* m_canvasView;
+    GridHeatmapView* m_heatmapView;
+    RenderMode m_renderMode = WidgetRendering;
+    PowerMode m_powerMode = Interactive;
+    QTimer* m_autoLayoutTimer;
+    bool m_autoLayout = false;
+    int m_autoLayoutCount = -1;
+    int m_page = 0;
+    int m_pageCount = 1;
 
     int m_rows;
     int m_cols;
     static constexpr int GRID_ROWS_DEFAULT = 3;
     static constexpr int GRID_COLUMNS_DEFAUT = 3;
+    static constexpr int UNFOCUSED_FRAME_RATE = 10;
+    static constexpr int UNFOCUSED_ANIMATION_INTERVAL_MS = 100;
+    static constexpr int BACKGROUND_REFRESH_INTERVAL_MS = 30000;
+    static constexpr int BACKGROUND_STATS_INTERVAL_MS = 5000;
+    static constexpr int AUTO_CELL_WIDTH_MIN = 260;
+    static constexpr int AUTO_CELL_HEIGHT_MIN = 180;
+    static constexpr int AUTO_LAYOUT_DELAY_MS = 150;
 };
 
 #endif // GRIDMANAGER_H
@@ -0,0 +1,109 @@
+#include "gridplacement.h"
+
+#include <QHash>
+#include <algorithm>
+
+void GridPlacement::setRankTolerance(int positions)
+{
+    m_rankTolerance = qMax(0, positions);
+}
+
+int GridPlacement::rankTolerance() const
+{
+    return m_rankTolerance;
+}
+
+GridPlacement::Result GridPlacement::place(const QStringList& layout, const QStringList& ranked,
+                                           const QSet<QString>& pinned, int cols, int minRows) const
+{
+    Result result;
+    const int count = ranked.size();
+    result.slots.fill(-1, count);
+    if(cols <= 0)
+        return result;
+
+    // Current slot of every ranked interface. A key that repeats is
+    // matched occurrence by occurrence, in slot order, so each copy keeps
+    // a cell of its own
+    QHash<QString, QVector<int>> slotsByKey;
+    slotsByKey.reserve(layout.size());
+    for(int i = 0; i < layout.size(); ++i)
+    {
+        if(!layout[i].isEmpty())
+            slotsByKey[layout[i]].append(i);
+    }
+    QVector<int> current(count, -1);
+    QHash<QString, int> seen;
+    for(int i = 0; i < count; ++i)
+    {
+        const QVector<int> keySlots = slotsByKey.value(ranked[i]);
+        const int occurrence = seen[ranked[i]]++;
+        if(occurrence < keySlots.size())
+            current[i] = keySlots[occurrence];
+    }
+
+    result.rows = qMax(minRows, (count + cols - 1) / cols);
+    for(int i = 0; i < count; ++i)
+    {
+        if(pinned.contains(ranked[i]) && current[i] >= 0)
+            result.rows = qMax(result.rows, current[i] / cols + 1);
+    }
+    const int capacity = result.rows * cols;
+    QVector<bool> taken(capacity, false);
+
+    auto assign = [&](int i, int slot)
+    {
+        if(slot < 0 || slot >= capacity || taken[slot])
+            return false;
+        result.slots[i] = slot;
+        taken[slot] = true;
+        return true;
+    };
+
+    for(int i = 0; i < count; ++i)
+    {
+        if(pinned.contains(ranked[i]))
+            assign(i, current[i]);
+    }
+
+    // Interfaces that can stay, in rank order; compare that order with the
+    // one they are shown in now
+    QVector<int> kept;
+    for(int i = 0; i < count; ++i)
+    {
+        const int slot = current[i];
+        if(result.slots[i] < 0 && slot >= 0 && slot < capacity && !taken[slot])
+            kept.append(i);
+    }
+    QVector<int> shown = kept;
+    std::sort(shown.begin(), shown.end(), [&](int a, int b)
+              {
+                  return current[a] < current[b];
+              });
+    for(int pos = 0; pos < shown.size() && !result.reordered; ++pos)
+    {
+        const int rank = int(std::lower_bound(kept.cbegin(), kept.cend(), shown[pos]) - kept.cbegin());
+        result.reordered = qAbs(rank - pos) > m_rankTolerance;
+    }
+
+    if(!result.reordered)
+    {
+        for(int i : std::as_const(kept))
+        {
+            assign(i, current[i]);
+        }
+    }
+
+    int nextFree = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        if(result.slots[i] >= 0)
+            continue;
+        while(taken[nextFree])
+        {
+            ++nextFree;
+        }
+        assign(i, nextFree);
+    }
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef GRIDPLACEMENT_H
+#define GRIDPLACEMENT_H
+
+#include <QVector>
+#include <QStringList>
+#include <QSet>
+
+// Decides which slot every interface of a fresh, ranked parse goes to so
+// that as few cells as possible change:
+//  - pinned interfaces keep their slot (the grid grows to keep it in range),
+//  - interfaces still present keep their slot unless the ranking moved one
+//    of them by more than rankTolerance positions, in which case the
+//    unpinned ones are laid out in rank order again,
+//  - new interfaces (and any that had to move) take the free slots in
+//    row-major order; removed ones simply leave their slot free.
+class GridPlacement
+{
+public:
+    struct Result
+    {
+        QVector<int> slots;// per ranked interface
+        int rows = 0;
+        bool reordered = false;
+    };
+
+    static constexpr int RANK_TOLERANCE_DEFAULT = 3;
+
+    void setRankTolerance(int positions);
+    int rankTolerance() const;
+
+    // layout holds the current key (interface name) per slot, empty for
+    // free slots; keys may repeat, interfaces with an empty key are always
+    // placed as new
+    Result place(const QStringList& layout, const QStringList& ranked,
+                 const QSet<QString>& pinned, int cols, int minRows) const;
+
+private:
+    int m_rankTolerance = RANK_TOLERANCE_DEFAULT;
+};
+
+#endif // GRIDPLACEMENT_H
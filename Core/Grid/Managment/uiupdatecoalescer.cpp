@@ -0,0 +1,179 @@
+#include "uiupdatecoalescer.h"
+
+#include "../../Network/Information/networkinfomodel.h"
+#include "../Utilities/Logger/logger.h"
+
+#include <QMutexLocker>
+
+UiUpdateCoalescer::UiUpdateCoalescer(QObject* parent)
+    : QObject{parent},
+    m_frameIntervalMs(1000 / DEFAULT_FRAME_RATE)
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &UiUpdateCoalescer::flush);
+    m_sinceFlush.start();
+}
+
+void UiUpdateCoalescer::setMaxFrameRate(int framesPerSecond)
+{
+    m_frameIntervalMs = 1000 / qBound(1, framesPerSecond, 1000);
+}
+
+int UiUpdateCoalescer::maxFrameRate() const
+{
+    return 1000 / m_frameIntervalMs;
+}
+
+void UiUpdateCoalescer::setPaused(bool paused)
+{
+    bool catchUp = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        if(m_paused == paused)
+            return;
+
+        m_paused = paused;
+        m_flushScheduled = false;
+        catchUp = !paused && (!m_dirtyCells.isEmpty() || !m_dirtyModels.isEmpty() || m_snapshotDirty);
+    }
+
+    m_frameTimer.stop();
+    if(catchUp)
+    {
+        flush();
+    }
+}
+
+bool UiUpdateCoalescer::isPaused() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_paused;
+}
+
+void UiUpdateCoalescer::markCellDirty(const QPoint& cell)
+{
+    QMutexLocker lock(&m_mutex);
+    ++m_stats.cellRequests;
+    if(m_dirtyCells.contains(cell))
+    {
+        ++m_stats.merged;
+        return;
+    }
+    m_dirtyCells.insert(cell);
+    scheduleFlushLocked();
+}
+
+void UiUpdateCoalescer::markModelDirty(NetworkInfoModel* model)
+{
+    QMutexLocker lock(&m_mutex);
+    ++m_stats.modelRequests;
+    if(m_dirtyModels.contains(model))
+    {
+        ++m_stats.merged;
+        return;
+    }
+    m_dirtyModels.insert(model, QPointer<NetworkInfoModel>(model));
+    scheduleFlushLocked();
+}
+
+void UiUpdateCoalescer::markSnapshotDirty()
+{
+    QMutexLocker lock(&m_mutex);
+    if(m_snapshotDirty)
+        return;
+    m_snapshotDirty = true;
+    scheduleFlushLocked();
+}
+
+void UiUpdateCoalescer::watchModel(NetworkInfoModel* model)
+{
+    if(!model || m_watched.contains(model))
+        return;
+
+    m_watched.insert(model, connect(model, &NetworkInfoModel::propertyChanged,
+                                    this, [this, model]()
+                                    {
+                                        markModelDirty(model);
+                                    }, Qt::DirectConnection));
+    connect(model, &QObject::destroyed, this, [this, model]()
+            {
+                m_watched.remove(model);
+            });
+}
+
+UiUpdateCoalescer::Stats UiUpdateCoalescer::stats() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
+
+void UiUpdateCoalescer::scheduleFlushLocked()
+{
+    if(m_flushScheduled || m_paused)
+        return;
+
+    // The frame timer belongs to the GUI thread
+    m_flushScheduled = true;
+    QMetaObject::invokeMethod(this, &UiUpdateCoalescer::startFrameTimer, Qt::QueuedConnection);
+}
+
+void UiUpdateCoalescer::startFrameTimer()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        if(m_paused)
+            return;
+    }
+
+    const qint64 remaining = m_frameIntervalMs - m_sinceFlush.elapsed();
+    m_frameTimer.start(int(qMax<qint64>(0, remaining)));
+}
+
+void UiUpdateCoalescer::flush()
+{
+    QSet<QPoint> cells;
+    QHash<NetworkInfoModel*, QPointer<NetworkInfoModel>> models;
+    bool snapshot = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        cells.swap(m_dirtyCells);
+        models.swap(m_dirtyModels);
+        std::swap(snapshot, m_snapshotDirty);
+        m_flushScheduled = false;
+    }
+    m_sinceFlush.restart();
+
+    QList<NetworkInfoModel*> liveModels;
+    liveModels.reserve(models.size());
+    quint64 dropped = 0;
+    for(const QPointer<NetworkInfoModel>& model : std::as_const(models))
+    {
+        if(model)
+            liveModels.append(model.data());
+        else
+            ++dropped;
+    }
+
+    if(!cells.isEmpty() || !liveModels.isEmpty())
+    {
+        emit frameReady(QList<QPoint>(cells.cbegin(), cells.cend()), liveModels);
+    }
+    if(snapshot)
+    {
+        emit snapshotFrameReady();
+    }
+
+    Stats stats;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stats.dropped += dropped;
+        ++m_stats.frames;
+        stats = m_stats;
+    }
+    if(stats.frames % STATS_LOG_INTERVAL == 0)
+    {
+        LOG_DEBUG("UI", "UI frames %1: %2 cell and %3 model updates, %4 merged, %5 dropped",
+                  stats.frames, stats.cellRequests, stats.modelRequests, stats.merged, stats.dropped);
+    }
+}
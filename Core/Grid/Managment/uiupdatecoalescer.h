@@ -0,0 +1,81 @@
+#ifndef UIUPDATECOALESCER_H
+#define UIUPDATECOALESCER_H
+
+#include <QObject>
+#include <QPoint>
+#include <QSet>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QTimer>
+#include <QPointer>
+#include <QElapsedTimer>
+
+class NetworkInfoModel;
+
+// Collects dirty cells and models from any thread and hands them to the
+// GUI thread as one batch, at most once per frame. Repeated marks of the
+// same cell or model inside a frame are merged; marks for models deleted
+// before the frame is flushed are dropped. While paused, marks keep
+// accumulating (merged as usual) and are delivered in one frame on resume.
+class UiUpdateCoalescer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Stats
+    {
+        quint64 cellRequests = 0;
+        quint64 modelRequests = 0;
+        quint64 merged = 0;
+        quint64 dropped = 0;
+        quint64 frames = 0;
+    };
+
+    static constexpr int DEFAULT_FRAME_RATE = 30;
+
+    explicit UiUpdateCoalescer(QObject* parent = nullptr);
+
+    void setMaxFrameRate(int framesPerSecond);
+    int maxFrameRate() const;
+
+    // GUI thread
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    // Thread-safe
+    void markCellDirty(const QPoint& cell);
+    void markModelDirty(NetworkInfoModel* model);
+    // Whole-grid views (overviews) only need to know that something changed
+    void markSnapshotDirty();
+
+    // GUI thread: routes the model's field changes through this coalescer
+    void watchModel(NetworkInfoModel* model);
+
+    Stats stats() const;
+
+signals:
+    void frameReady(const QList<QPoint>& cells, const QList<NetworkInfoModel*>& models);
+    void snapshotFrameReady();
+
+private:
+    void scheduleFlushLocked();
+    void startFrameTimer();
+    void flush();
+
+    mutable QMutex m_mutex;
+    QSet<QPoint> m_dirtyCells;
+    QHash<NetworkInfoModel*, QPointer<NetworkInfoModel>> m_dirtyModels;
+    bool m_snapshotDirty = false;
+    bool m_flushScheduled = false;
+    bool m_paused = false;
+    Stats m_stats;
+
+    QHash<NetworkInfoModel*, QMetaObject::Connection> m_watched;
+    QTimer m_frameTimer;
+    QElapsedTimer m_sinceFlush;
+    int m_frameIntervalMs;
+
+    static constexpr int STATS_LOG_INTERVAL = 300;// frames
+};
+
+#endif // UIUPDATECOALESCER_H
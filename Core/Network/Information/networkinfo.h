@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QDateTime>
 
+#include "speedhistory.h"
+
 class NetworkInfo : public QObject
 {
     Q_OBJECT
@@ -46,6 +48,8 @@ public:
     qint64 getTxSpeed() const { return m_txSpeed; }
     quint64 getTotalSpeed() const { return static_cast<quint64>(m_rxSpeed + m_txSpeed); }
     qint64 getLastUpdateTime() const { return m_lastUpdateTime; }
+    SpeedHistory& speedHistory() { return m_speedHistory; }
+    const SpeedHistory& speedHistory() const { return m_speedHistory; }
 
     void setName(const QString &name);
     void setMac(const QString &mac);
@@ -103,6 +107,7 @@ private:
     qint64 m_rxSpeed;
     qint64 m_txSpeed;
     qint64 m_lastUpdateTime;
+    SpeedHistory m_speedHistory;
 };
 
 Q_DECLARE_METATYPE(NetworkInfo*)
@@ -5,7 +5,13 @@ NetworkInfoModel::NetworkInfoModel(NetworkInfo *model, QObject *parent)
     : QObject(parent),
     m_model(model)
 {
-    m_propertyMap =
+    connectModelSignals();
+}
+
+// Shared by every model; the labels never differ per interface
+const QHash<QString, QString>& NetworkInfoModel::propertyMap()
+{
+    static const QHash<QString, QString> labels =
         {
             {"name", "Interface"},
             {"mac", "MAC Address"},
@@ -17,57 +23,136 @@ NetworkInfoModel::NetworkInfoModel(NetworkInfo *model, QObject *parent)
             {"totalSpeed", "Total Speed"},
             {"lastUpdate", "Last Update"}
         };
+    return labels;
+}
 
-    connectModelSignals();
+QString NetworkInfoModel::fieldProperty(Field field)
+{
+    static const char* const properties[FieldCount] =
+        {
+            "name", "mac", "ipAddress", "netmask", "status",
+            "downloadSpeed", "uploadSpeed", "totalSpeed", "lastUpdate"
+        };
+    return field < FieldCount ? QString(properties[field]) : QString();
+}
+
+NetworkInfoModel::Field NetworkInfoModel::fieldForProperty(const QString& property)
+{
+    static const QHash<QString, Field> fields = []
+    {
+        QHash<QString, Field> result;
+        for(int field = 0; field < FieldCount; ++field)
+        {
+            result.insert(fieldProperty(Field(field)), Field(field));
+        }
+        return result;
+    }();
+    return fields.value(property, FieldCount);
+}
+
+QString NetworkInfoModel::fieldLabel(Field field) const
+{
+    return propertyMap().value(fieldProperty(field));
+}
+
+QString NetworkInfoModel::fieldValue(Field field) const
+{
+    switch(field)
+    {
+    case NameField:
+        return getName();
+    case MacField:
+        return getMac();
+    case IpAddressField:
+        return getIpAddress();
+    case NetmaskField:
+        return getNetmask();
+    case StatusField:
+        return getStatus();
+    case DownloadSpeedField:
+        return getDownloadSpeed();
+    case UploadSpeedField:
+        return getUploadSpeed();
+    case TotalSpeedField:
+        return getTotalSpeed();
+    case LastUpdateField:
+        return getLastUpdate();
+    case FieldCount:
+        break;
+    }
+    return QString();
 }
 
 QList<QPair<QString, QString>> NetworkInfoModel::getAllKeyValuesAsList() const
 {
     return
         {
-            {m_propertyMap["name"], getName()},
-            {m_propertyMap["mac"], getMac()},
-            {m_propertyMap["ipAddress"], getIpAddress()},
-            {m_propertyMap["netmask"], getNetmask()},
-            {m_propertyMap["status"], getStatus()},
-            {m_propertyMap["downloadSpeed"], getDownloadSpeed()},
-            {m_propertyMap["uploadSpeed"], getUploadSpeed()},
-            {m_propertyMap["totalSpeed"], getTotalSpeed()},
-            {m_propertyMap["lastUpdate"], getLastUpdate()}
+            {propertyMap()["name"], getName()},
+            {propertyMap()["mac"], getMac()},
+            {propertyMap()["ipAddress"], getIpAddress()},
+            {propertyMap()["netmask"], getNetmask()},
+            {propertyMap()["status"], getStatus()},
+            {propertyMap()["downloadSpeed"], getDownloadSpeed()},
+            {propertyMap()["uploadSpeed"], getUploadSpeed()},
+            {propertyMap()["totalSpeed"], getTotalSpeed()},
+            {propertyMap()["lastUpdate"], getLastUpdate()}
         };
 }
 
 QPair<QString, QString> NetworkInfoModel::getKeyValue(const QString &key) const
 {
-    if(key == m_propertyMap["name"])
+    if(key == propertyMap()["name"])
         return {key, getName()};
-    if(key == m_propertyMap["mac"])
+    if(key == propertyMap()["mac"])
         return {key, getMac()};
-    if(key == m_propertyMap["ipAddress"])
+    if(key == propertyMap()["ipAddress"])
         return {key, getIpAddress()};
-    if(key == m_propertyMap["netmask"])
+    if(key == propertyMap()["netmask"])
         return {key, getNetmask()};
-    if(key == m_propertyMap["status"])
+    if(key == propertyMap()["status"])
         return {key, getStatus()};
-    if(key == m_propertyMap["downloadSpeed"])
+    if(key == propertyMap()["downloadSpeed"])
         return {key, getDownloadSpeed()};
-    if(key == m_propertyMap["uploadSpeed"])
+    if(key == propertyMap()["uploadSpeed"])
         return {key, getUploadSpeed()};
-    if(key == m_propertyMap["totalSpeed"])
+    if(key == propertyMap()["totalSpeed"])
         return {key, getTotalSpeed()};
-    if(key == m_propertyMap["lastUpdate"])
+    if(key == propertyMap()["lastUpdate"])
         return {key, getLastUpdate()};
     return {QString(), QString()};
 }
 
 QStringList NetworkInfoModel::changedProperties() const
 {
-    return m_changedProperties;
+    QStringList properties;
+    const quint32 fields = m_changedFields.loadRelaxed();
+    for(int field = 0; field < FieldCount; ++field)
+    {
+        if(fields & (1u << field))
+        {
+            properties << fieldProperty(Field(field));
+        }
+    }
+    return properties;
 }
 
 void NetworkInfoModel::clearChangedProperties()
 {
-    m_changedProperties.clear();
+    m_changedFields.storeRelaxed(0);
+}
+
+quint32 NetworkInfoModel::takeChangedFields()
+{
+    return m_changedFields.fetchAndStoreAcquire(0);
+}
+
+void NetworkInfoModel::publishChangedFields()
+{
+    const quint32 fields = takeChangedFields();
+    if(fields)
+    {
+        emit fieldsChanged(fields);
+    }
 }
 
 void NetworkInfoModel::updateFromNetworkInfo(NetworkInfo* newInfo)
@@ -80,6 +165,30 @@ void NetworkInfoModel::updateFromNetworkInfo(NetworkInfo* newInfo)
     delete newInfo;//TODO:mb remove and use std::move
 }
 
+// A model detached with nullptr keeps answering from an empty interface,
+// so a view still bound to it until its next rebind never reads freed data
+void NetworkInfoModel::rebind(NetworkInfo* info)
+{
+    static NetworkInfo* const detached = new NetworkInfo();// never freed, shared by all
+    if(!info)
+        info = detached;
+    if(m_model == info)
+        return;
+
+    if(m_model)
+    {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = info;
+    if(m_model == detached)
+        return;
+
+    connectModelSignals();
+    m_changedFields.fetchAndOrRelease((1u << FieldCount) - 1);
+    emit propertyChanged(fieldProperty(MacField));
+    emit macChanged(getMac());
+}
+
 QString NetworkInfoModel::getName() const
 {
     return m_model->getName();
@@ -125,6 +234,11 @@ QString NetworkInfoModel::getLastUpdate() const
     return formatTimestamp();
 }
 
+const SpeedHistory& NetworkInfoModel::speedHistory() const
+{
+    return m_model->speedHistory();
+}
+
 void NetworkInfoModel::updateSpeeds(quint64 rx, quint64 tx)
 {
     m_model->setRxSpeed(static_cast<qint64>(rx));
@@ -163,7 +277,7 @@ void NetworkInfoModel::connectModelSignals()
         connect(m_model, signal, this, [this, property]()
                 {
                     markPropertyChanged(property);
-                });
+                }, Qt::DirectConnection);
     };
 
     connectProperty("name", &NetworkInfo::nameChanged);
@@ -172,29 +286,33 @@ void NetworkInfoModel::connectModelSignals()
     connectProperty("netmask", &NetworkInfo::netmaskChanged);
     connectProperty("status", &NetworkInfo::isUpChanged);
 
+    // NetworkInfo is only written on the GUI thread (stats are queued and
+    // applied there by GridDataManager), so these fire on the GUI thread
+    // and the change is recorded without a queued hop.
     connect(m_model, &NetworkInfo::rxSpeedChanged, this, [this]()
             {
                 markPropertyChanged("downloadSpeed");
                 markPropertyChanged("totalSpeed");
-            });
+            }, Qt::DirectConnection);
 
     connect(m_model, &NetworkInfo::txSpeedChanged, this, [this]()
             {
                 markPropertyChanged("uploadSpeed");
                 markPropertyChanged("totalSpeed");
-            });
+            }, Qt::DirectConnection);
 
     connect(m_model, &NetworkInfo::lastUpdateTimeChanged, this, [this]()
             {
                 markPropertyChanged("lastUpdate");
-            });
+            }, Qt::DirectConnection);
 }
 
 void NetworkInfoModel::markPropertyChanged(const QString &property)
 {
-    if(!m_changedProperties.contains(property))
+    const Field field = fieldForProperty(property);
+    if(field != FieldCount)
     {
-        m_changedProperties.append(property);
-        emit propertyChanged(property);
+        m_changedFields.fetchAndOrRelease(1u << field);
     }
+    emit propertyChanged(property);
 }
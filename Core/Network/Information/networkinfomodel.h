@@ -3,8 +3,10 @@
 
 #include <QObject>
 #include <QHash>
+#include <QAtomicInteger>
 
 class NetworkInfo;
+class SpeedHistory;
 
 class NetworkInfoModel : public QObject
 {
@@ -20,14 +22,42 @@ class NetworkInfoModel : public QObject
     Q_PROPERTY(QString lastUpdate READ getLastUpdate NOTIFY timestampChanged)
 
 public:
+    // Display order of the key/value rows
+    enum Field
+    {
+        NameField,
+        MacField,
+        IpAddressField,
+        NetmaskField,
+        StatusField,
+        DownloadSpeedField,
+        UploadSpeedField,
+        TotalSpeedField,
+        LastUpdateField,
+        FieldCount
+    };
+
     explicit NetworkInfoModel(NetworkInfo* model, QObject* parent = nullptr);
 
-    const QHash<QString, QString>& propertyMap() const { return m_propertyMap; }//TODO:mb remove
+    static QString fieldProperty(Field field);
+    static Field fieldForProperty(const QString& property);// FieldCount if unknown
+    QString fieldLabel(Field field) const;
+    QString fieldValue(Field field) const;
+
+    static const QHash<QString, QString>& propertyMap();//TODO:mb remove
     QList<QPair<QString, QString>> getAllKeyValuesAsList() const;
     QPair<QString, QString> getKeyValue(const QString& key) const;
     QStringList changedProperties() const;
     void clearChangedProperties();
+    // Bitmask of Fields changed since the last call; safe from any thread
+    quint32 takeChangedFields();
+    // Main thread: emits fieldsChanged() with everything changed so far
+    void publishChangedFields();
     void updateFromNetworkInfo(NetworkInfo* newInfo);
+    // Points a recycled model at another interface, or detaches it with
+    // nullptr; every field counts as changed so bound views refresh completely
+    void rebind(NetworkInfo* info);
+    NetworkInfo* networkInfo() const { return m_model; }
 
     QString getName() const;
     QString getMac() const;
@@ -38,12 +68,15 @@ public:
     QString getTotalSpeed() const;
     QString getStatus() const;
     QString getLastUpdate() const;
+    const SpeedHistory& speedHistory() const;
 
 public slots:
     void updateSpeeds(quint64 rx, quint64 tx);
 
 signals:
+    // Emitted on the thread that changed the property, for every change
     void propertyChanged(const QString& propertyName);
+    void fieldsChanged(quint32 fields);
 
     void nameChanged(const QString& name);
     void macChanged(const QString& mac);
@@ -60,8 +93,7 @@ private:
     QString formatSpeed(quint64 bytes) const;
 
     NetworkInfo* m_model;
-    QStringList m_changedProperties;
-    QHash<QString, QString> m_propertyMap;
+    QAtomicInteger<quint32> m_changedFields{0};
 };
 
 #endif // NETWORKINFOMODEL_H
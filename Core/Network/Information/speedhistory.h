@@ -0,0 +1,55 @@
+#ifndef SPEEDHISTORY_H
+#define SPEEDHISTORY_H
+
+#include <QAtomicInteger>
+#include <array>
+
+// Ring of the most recent rx/tx speed samples of one interface. There is
+// a single writer (the stats task, serialized by GridDataManager); readers
+// on any thread only look at sequence numbers below sampleCount().
+class SpeedHistory
+{
+public:
+    struct Sample
+    {
+        qint64 rx = 0;
+        qint64 tx = 0;
+    };
+
+    static constexpr int Capacity = 180;// 3 minutes at the 1 s monitor rate
+
+    void append(qint64 rx, qint64 tx)
+    {
+        const quint64 count = m_count.loadRelaxed();
+        Slot& slot = m_slots[count % Capacity];
+        slot.rx.storeRelaxed(rx);
+        slot.tx.storeRelaxed(tx);
+        m_count.storeRelease(count + 1);
+    }
+
+    // Samples appended so far; only the last Capacity of them are kept
+    quint64 sampleCount() const { return m_count.loadAcquire(); }
+    quint64 firstAvailable() const
+    {
+        const quint64 count = sampleCount();
+        return count > quint64(Capacity) ? count - Capacity : 0;
+    }
+
+    Sample sample(quint64 sequence) const
+    {
+        const Slot& slot = m_slots[sequence % Capacity];
+        return {slot.rx.loadRelaxed(), slot.tx.loadRelaxed()};
+    }
+
+private:
+    struct Slot
+    {
+        QAtomicInteger<qint64> rx{0};
+        QAtomicInteger<qint64> tx{0};
+    };
+
+    std::array<Slot, Capacity> m_slots;
+    QAtomicInteger<quint64> m_count{0};
+};
+
+#endif // SPEEDHISTORY_H
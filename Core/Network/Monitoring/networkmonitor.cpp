@@ -27,16 +27,40 @@ NetworkMonitor::NetworkMonitor(TaskScheduler* scheduler, QObject* parent)
 
 void NetworkMonitor::startMonitoring(int intervalMs)
 {
+    m_interval = intervalMs;
     m_scheduler->scheduleRepeating("network_monitoring", intervalMs, this,
                                    &NetworkMonitor::refreshStats,
                                    QThread::NormalPriority);
-    Logger::instance().log(Logger::Info,
-                           QString("Network monitoring started (interval %1ms)").arg(intervalMs), "Network");
+    LOG_INFO("Network", "Network monitoring started (interval %1ms)", intervalMs);
 }
 
 void NetworkMonitor::stopMonitoring()
 {
-    //m_timer.stop();
+    if(m_scheduler)
+    {
+        m_scheduler->cancelRepeating("network_monitoring");
+    }
+}
+
+void NetworkMonitor::setInterval(int intervalMs)
+{
+    if(intervalMs == m_interval)
+        return;
+
+    m_interval = intervalMs;
+    LOG_DEBUG("Network", "Network monitoring interval set to %1ms", intervalMs);
+    if(m_scheduler)
+    {
+        m_scheduler->setRepeatingInterval("network_monitoring", intervalMs);
+    }
+}
+
+void NetworkMonitor::sampleNow()
+{
+    if(m_scheduler)
+    {
+        m_scheduler->triggerRepeating("network_monitoring");
+    }
 }
 
 void NetworkMonitor::refreshStats()
@@ -46,6 +70,10 @@ void NetworkMonitor::refreshStats()
     {
         calculateSpeeds(currentStats);
     }
+    else
+    {
+        LOG_DEBUG("Network", "Failed to read interface statistics");
+    }
 }
 
 void NetworkMonitor::monitoringLoop()
@@ -106,7 +134,11 @@ bool NetworkMonitor::readRawInterfaceStats(QHash<QString, InterfaceStats>& stats
     for(ULONG i = 0; i < ifTable->NumEntries; i++)
     {
         MIB_IF_ROW2* ifRow = &ifTable->Table[i];
-        QString name = QString::fromWCharArray(ifRow->Description);
+        // The LUID name is what QNetworkInterface::name() reports
+        wchar_t luidName[NDIS_IF_MAX_STRING_SIZE + 1];
+        if(ConvertInterfaceLuidToNameW(&ifRow->InterfaceLuid, luidName, NDIS_IF_MAX_STRING_SIZE + 1) != NO_ERROR)
+            continue;
+        QString name = QString::fromWCharArray(luidName);
 
         stats[name].rxBytes = ifRow->InOctets;
         stats[name].txBytes = ifRow->OutOctets;
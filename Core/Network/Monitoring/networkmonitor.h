@@ -15,9 +15,13 @@ public:
 
     void startMonitoring(int intervalMs = 1000);
     void stopMonitoring();
+    void setInterval(int intervalMs);
+    void sampleNow();
 
 signals:
-    void statsUpdated(const QString& mac,
+    // Keyed by interface name, as QNetworkInterface::name() reports it;
+    // emitted on the pool thread that took the sample
+    void statsUpdated(const QString& name,
                       quint64 downloadSpeedBps,
                       quint64 uploadSpeedBps);
     // public slots:
@@ -43,7 +47,7 @@ private:
 
     TaskScheduler* m_scheduler;
     QAtomicInt m_running{0};
-    int m_interval;
+    int m_interval = 1000;
 
     QHash<QString, InterfaceStats> m_previousStats;
 };
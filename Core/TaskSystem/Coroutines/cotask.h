@@ -0,0 +1,28 @@
+#ifndef COTASK_H
+#define COTASK_H
+
+#include <coroutine>
+#include <exception>
+
+#include "../taskallocator.h"
+
+// Fire-and-forget coroutine type used with the TaskScheduler awaitables
+// (onPool, onMainThread, after). The frame is allocated from the task slab
+// allocator and destroys itself when the coroutine body finishes.
+class CoTask
+{
+public:
+    struct promise_type
+    {
+        CoTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(std::size_t size) { return TaskAllocator::allocate(size); }
+        static void operator delete(void* ptr, std::size_t size) { TaskAllocator::deallocate(ptr, size); }
+    };
+};
+
+#endif // COTASK_H
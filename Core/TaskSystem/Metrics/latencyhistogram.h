@@ -0,0 +1,117 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QAtomicInteger>
+#include <QtAlgorithms>
+#include <QtGlobal>
+#include <array>
+
+// Log-linear (HDR style) bucketing of nanosecond latencies: every power of
+// two is split into 8 linear sub-buckets, which keeps the relative error
+// under 12.5% from 1 ns up to ~18 minutes in 312 buckets.
+namespace LatencyBuckets
+{
+constexpr int SubBucketBits = 3;
+constexpr int SubBucketCount = 1 << SubBucketBits;
+constexpr int MaxExponent = 40;
+constexpr int Count = (MaxExponent - SubBucketBits + 1) * SubBucketCount + SubBucketCount;
+
+inline int indexFor(qint64 value)
+{
+    if(value < SubBucketCount)
+        return value < 0 ? 0 : int(value);
+
+    int msb = 63 - qCountLeadingZeroBits(quint64(value));
+    if(msb > MaxExponent)
+        return Count - 1;
+
+    const int sub = int(value >> (msb - SubBucketBits)) & (SubBucketCount - 1);
+    return (msb - SubBucketBits + 1) * SubBucketCount + sub;
+}
+
+inline qint64 lowerBound(int index)
+{
+    if(index < SubBucketCount)
+        return index;
+
+    const int msb = index / SubBucketCount + SubBucketBits - 1;
+    const int sub = index % SubBucketCount;
+    return qint64(SubBucketCount + sub) << (msb - SubBucketBits);
+}
+}
+
+class LatencyHistogram
+{
+public:
+    void record(qint64 value)
+    {
+        ++m_buckets[LatencyBuckets::indexFor(value)];
+        ++m_count;
+        m_max = qMax(m_max, value);
+    }
+
+    void add(int bucket, quint64 count) { m_buckets[bucket] += count; m_count += count; }
+    void merge(const LatencyHistogram& other)
+    {
+        for(int i = 0; i < LatencyBuckets::Count; ++i)
+            m_buckets[i] += other.m_buckets[i];
+        m_count += other.m_count;
+        m_max = qMax(m_max, other.m_max);
+    }
+    void raiseMax(qint64 value) { m_max = qMax(m_max, value); }
+
+    quint64 count() const { return m_count; }
+    qint64 max() const { return m_max; }
+
+    qint64 percentile(double q) const
+    {
+        if(m_count == 0)
+            return 0;
+
+        const quint64 rank = qMax<quint64>(1, quint64(q * m_count + 0.5));
+        quint64 seen = 0;
+        for(int i = 0; i < LatencyBuckets::Count; ++i)
+        {
+            seen += m_buckets[i];
+            if(seen >= rank)
+                return qMin(LatencyBuckets::lowerBound(i), m_max);
+        }
+        return m_max;
+    }
+
+private:
+    std::array<quint64, LatencyBuckets::Count> m_buckets{};
+    quint64 m_count = 0;
+    qint64 m_max = 0;
+};
+
+// Single-writer variant kept per thread: the owner updates with relaxed
+// load/store pairs (no read-modify-write), readers merge a snapshot.
+class ThreadLatencyHistogram
+{
+public:
+    void record(qint64 value)
+    {
+        QAtomicInteger<quint64>& bucket = m_buckets[LatencyBuckets::indexFor(value)];
+        bucket.storeRelaxed(bucket.loadRelaxed() + 1);
+        if(value > m_max.loadRelaxed())
+            m_max.storeRelaxed(value);
+    }
+
+    void mergeInto(LatencyHistogram& target) const
+    {
+        for(int i = 0; i < LatencyBuckets::Count; ++i)
+        {
+            const quint64 count = m_buckets[i].loadRelaxed();
+            if(count)
+                target.add(i, count);
+        }
+        target.raiseMax(m_max.loadRelaxed());
+    }
+
+private:
+    std::array<QAtomicInteger<quint64>, LatencyBuckets::Count> m_buckets{};
+    QAtomicInteger<qint64> m_max{0};
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,199 @@
+#include "taskmetrics.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <chrono>
+
+qint64 TaskMetrics::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef UGNSM_TASK_METRICS
+
+#include <QAtomicPointer>
+#include <array>
+
+namespace
+{
+struct KeyCounters
+{
+    QAtomicInteger<quint64> tasks{0};
+    ThreadLatencyHistogram queueWait;
+    ThreadLatencyHistogram lockWait;
+    ThreadLatencyHistogram runTime;
+};
+
+struct ThreadCounters
+{
+    std::array<QAtomicPointer<KeyCounters>, TaskMetrics::MaxResourceKeys> keys{};
+
+    ~ThreadCounters()
+    {
+        for(QAtomicPointer<KeyCounters>& key : keys)
+        {
+            delete key.loadRelaxed();
+        }
+    }
+};
+
+void mergeKey(const KeyCounters& source, TaskMetrics::KeySnapshot& target)
+{
+    target.tasks += source.tasks.loadRelaxed();
+    source.queueWait.mergeInto(target.queueWait);
+    source.lockWait.mergeInto(target.lockWait);
+    source.runTime.mergeInto(target.runTime);
+}
+
+class MetricsRegistry
+{
+public:
+    int registerResourceKey(const QString& resourceKey)
+    {
+        QMutexLocker lock(&m_mutex);
+        int id = m_keyNames.indexOf(resourceKey);
+        if(id < 0 && m_keyNames.size() < TaskMetrics::MaxResourceKeys)
+        {
+            m_keyNames.append(resourceKey);
+            id = m_keyNames.size() - 1;
+        }
+        return id;
+    }
+
+    ThreadCounters* attach()
+    {
+        QMutexLocker lock(&m_mutex);
+        ThreadCounters* counters = new ThreadCounters;
+        m_live.append(counters);
+        return counters;
+    }
+
+    // Folds an exiting thread's counters into the retired totals so that
+    // expiring pool threads don't lose history or grow the live list.
+    void retire(ThreadCounters* counters)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_live.removeOne(counters);
+        for(int id = 0; id < TaskMetrics::MaxResourceKeys; ++id)
+        {
+            if(const KeyCounters* key = counters->keys[id].loadAcquire())
+                mergeKey(*key, m_retired[id]);
+        }
+        delete counters;
+    }
+
+    QList<TaskMetrics::KeySnapshot> snapshot()
+    {
+        QMutexLocker lock(&m_mutex);
+        QList<TaskMetrics::KeySnapshot> result;
+        result.reserve(m_keyNames.size());
+
+        for(int id = 0; id < m_keyNames.size(); ++id)
+        {
+            TaskMetrics::KeySnapshot key = m_retired[id];
+            key.resourceKey = m_keyNames[id];
+            for(const ThreadCounters* counters : std::as_const(m_live))
+            {
+                if(const KeyCounters* live = counters->keys[id].loadAcquire())
+                    mergeKey(*live, key);
+            }
+            result.append(key);
+        }
+        return result;
+    }
+
+private:
+    QMutex m_mutex;
+    QStringList m_keyNames;
+    QList<ThreadCounters*> m_live;
+    std::array<TaskMetrics::KeySnapshot, TaskMetrics::MaxResourceKeys> m_retired;
+};
+
+MetricsRegistry& registry()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+struct ThreadCountersHandle
+{
+    ThreadCounters* counters = nullptr;
+
+    ~ThreadCountersHandle()
+    {
+        if(counters)
+            registry().retire(counters);
+    }
+};
+
+thread_local ThreadCountersHandle t_counters;
+
+KeyCounters* countersFor(int keyId)
+{
+    if(keyId < 0)
+        return nullptr;
+
+    if(!t_counters.counters)
+        t_counters.counters = registry().attach();
+
+    QAtomicPointer<KeyCounters>& slot = t_counters.counters->keys[keyId];
+    KeyCounters* key = slot.loadRelaxed();
+    if(!key)
+    {
+        key = new KeyCounters;
+        slot.storeRelease(key);
+    }
+    return key;
+}
+}
+
+int TaskMetrics::registerResourceKey(const QString& resourceKey)
+{
+    return registry().registerResourceKey(resourceKey);
+}
+
+void TaskMetrics::recordQueueWait(int keyId, qint64 nanoseconds)
+{
+    if(KeyCounters* key = countersFor(keyId))
+        key->queueWait.record(nanoseconds);
+}
+
+void TaskMetrics::recordLockWait(int keyId, qint64 nanoseconds)
+{
+    if(KeyCounters* key = countersFor(keyId))
+        key->lockWait.record(nanoseconds);
+}
+
+void TaskMetrics::recordRunTime(int keyId, qint64 nanoseconds)
+{
+    if(KeyCounters* key = countersFor(keyId))
+    {
+        key->runTime.record(nanoseconds);
+        key->tasks.storeRelaxed(key->tasks.loadRelaxed() + 1);
+    }
+}
+
+QList<TaskMetrics::KeySnapshot> TaskMetrics::snapshot()
+{
+    return registry().snapshot();
+}
+
+#else
+
+int TaskMetrics::registerResourceKey(const QString&)
+{
+    return -1;
+}
+
+void TaskMetrics::recordQueueWait(int, qint64) {}
+void TaskMetrics::recordLockWait(int, qint64) {}
+void TaskMetrics::recordRunTime(int, qint64) {}
+
+QList<TaskMetrics::KeySnapshot> TaskMetrics::snapshot()
+{
+    return {};
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TASKMETRICS_H
+#define TASKMETRICS_H
+
+#include <QList>
+#include <QString>
+
+#include "latencyhistogram.h"
+
+// Scheduler instrumentation. Enabled with the UGNSM_TASK_METRICS build
+// option; without it TASK_METRICS(...) expands to nothing and the task
+// wrappers carry no extra state.
+#ifdef UGNSM_TASK_METRICS
+#define TASK_METRICS(...) __VA_ARGS__
+#else
+#define TASK_METRICS(...)
+#endif
+
+class TaskMetrics
+{
+public:
+    static constexpr int MaxResourceKeys = 64;
+
+    struct KeySnapshot
+    {
+        QString resourceKey;
+        quint64 tasks = 0;
+        LatencyHistogram queueWait;   // enqueue -> worker picked the task up
+        LatencyHistogram lockWait;    // time spent acquiring the resource mutex
+        LatencyHistogram runTime;     // executeTask() duration
+    };
+
+    static constexpr bool isEnabled()
+    {
+#ifdef UGNSM_TASK_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static qint64 now();
+    static int registerResourceKey(const QString& resourceKey);
+
+    static void recordQueueWait(int keyId, qint64 nanoseconds);
+    static void recordLockWait(int keyId, qint64 nanoseconds);
+    static void recordRunTime(int keyId, qint64 nanoseconds);
+
+    // Merges every thread's counters, including threads that already exited.
+    static QList<KeySnapshot> snapshot();
+};
+
+#endif // TASKMETRICS_H
@@ -0,0 +1,24 @@
+#ifndef COROUTINETASK_H
+#define COROUTINETASK_H
+
+#include "taskwrapperbase.h"
+#include <coroutine>
+
+class CoroutineTask : public TaskWrapperBase
+{
+public:
+    explicit CoroutineTask(std::coroutine_handle<> handle)
+        : m_handle(handle)
+    {
+    }
+
+    void executeTask() override
+    {
+        m_handle.resume();
+    }
+
+private:
+    std::coroutine_handle<> m_handle;
+};
+
+#endif // COROUTINETASK_H
@@ -14,7 +14,6 @@ public:
 
     void executeTask() override
     {
-        QMutexLocker lock(m_mutex);
         m_func();
     }
 
@@ -4,6 +4,8 @@
 #include "taskwrapperbase.h"
 #include <QObject>
 #include <QMutex>
+#include <tuple>
+#include <type_traits>
 
 template<class Receiver, typename... Args>
 class MethodTask : public TaskWrapperBase
@@ -32,7 +34,6 @@ public:
 
     void executeTask() override
     {
-        QMutexLocker lock(m_mutex);
         if(m_receiver)
         {
             executeImpl(std::index_sequence_for<Args...>{});
@@ -48,7 +49,7 @@ private:
 
     Receiver* m_receiver;
     Method m_method;
-    std::tuple<Args...> m_args;
+    std::tuple<std::decay_t<Args>...> m_args;
 //    QMutex* m_mutex = nullptr;
 };
 
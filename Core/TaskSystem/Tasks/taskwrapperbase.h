@@ -6,6 +6,19 @@
 //#include <QMetaType>
 #include <QMutex>
 #include <QThread>
+#include <QDeadlineTimer>
+
+#include "../taskallocator.h"
+#include "../Metrics/taskmetrics.h"
+
+class TaskWrapperBase;
+
+class TaskCompletionListener
+{
+public:
+    virtual ~TaskCompletionListener() = default;
+    virtual void taskFinished(TaskWrapperBase* task) = 0;
+};
 
 class TaskWrapperBase : public QRunnable
 {
@@ -17,18 +30,59 @@ public:
         setAutoDelete(true);
     }
 
+    static void* operator new(std::size_t size) { return TaskAllocator::allocate(size); }
+    static void operator delete(void* ptr, std::size_t size) { TaskAllocator::deallocate(ptr, size); }
+
     virtual void executeTask() = 0;
     void run() final
     {
-        executeTask();
+        TASK_METRICS(const qint64 startedAt = TaskMetrics::now();
+                     TaskMetrics::recordQueueWait(m_metricsKey, startedAt - m_enqueuedAt);)
+        {
+            QMutexLocker lock(m_mutex);
+            TASK_METRICS(const qint64 lockedAt = TaskMetrics::now();
+                         TaskMetrics::recordLockWait(m_metricsKey, lockedAt - startedAt);)
+            executeTask();
+            TASK_METRICS(TaskMetrics::recordRunTime(m_metricsKey, TaskMetrics::now() - lockedAt);)
+        }
+        if(m_listener)
+        {
+            m_listener->taskFinished(this);
+        }
     }
     void setMutex(QMutex* mutex) { m_mutex = mutex; }
 
     QThread::Priority taskPriority() const { return m_priority; }
+    void setTaskPriority(QThread::Priority priority) { m_priority = priority; }
+
+    const QString& resourceKey() const { return m_resourceKey; }
+    void setResourceKey(const QString& key) { m_resourceKey = key; }
+
+    QDeadlineTimer deadline() const { return m_deadline; }
+    void setDeadline(QDeadlineTimer deadline) { m_deadline = deadline; }
+
+    void setCompletionListener(TaskCompletionListener* listener) { m_listener = listener; }
+
+#ifdef UGNSM_TASK_METRICS
+    void markEnqueued(int metricsKey)
+    {
+        m_metricsKey = metricsKey;
+        m_enqueuedAt = TaskMetrics::now();
+    }
+#endif
 
 protected:
     QThread::Priority m_priority = QThread::NormalPriority;
     QMutex* m_mutex = nullptr;
+
+private:
+    QString m_resourceKey;
+    QDeadlineTimer m_deadline{QDeadlineTimer::Forever};
+    TaskCompletionListener* m_listener = nullptr;
+#ifdef UGNSM_TASK_METRICS
+    int m_metricsKey = -1;
+    qint64 m_enqueuedAt = 0;
+#endif
 };
 
 #endif // TASKWRAPPERBASE_H
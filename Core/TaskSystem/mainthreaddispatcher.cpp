@@ -0,0 +1,92 @@
+#include "mainthreaddispatcher.h"
+#include "Tasks/taskwrapperbase.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+
+namespace
+{
+const QEvent::Type DrainEvent = static_cast<QEvent::Type>(QEvent::registerEventType());
+}
+
+MainThreadDispatcher::MainThreadDispatcher(QObject* parent)
+    : QObject(parent)
+{
+}
+
+MainThreadDispatcher::~MainThreadDispatcher()
+{
+    QMutexLocker lock(&m_mutex);
+    qDeleteAll(m_batch);
+    qDeleteAll(m_pending);
+}
+
+void MainThreadDispatcher::post(TaskWrapperBase* task)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_pending.enqueue(task);
+    }
+    requestDrain();
+}
+
+void MainThreadDispatcher::setFrameBudget(int budgetMs)
+{
+    m_budgetMs.storeRelaxed(qMax(1, budgetMs));
+}
+
+int MainThreadDispatcher::frameBudget() const
+{
+    return m_budgetMs.loadRelaxed();
+}
+
+bool MainThreadDispatcher::event(QEvent* event)
+{
+    if(event->type() == DrainEvent)
+    {
+        drain();
+        return true;
+    }
+    return QObject::event(event);
+}
+
+void MainThreadDispatcher::requestDrain()
+{
+    if(m_drainRequested.testAndSetOrdered(0, 1))
+    {
+        QCoreApplication::postEvent(this, new QEvent(DrainEvent), Qt::LowEventPriority);
+    }
+}
+
+void MainThreadDispatcher::drain()
+{
+    m_drainRequested.storeRelease(0);
+
+    {
+        QMutexLocker lock(&m_mutex);
+        while(!m_pending.isEmpty())
+        {
+            m_batch.enqueue(m_pending.dequeue());
+        }
+    }
+
+    QElapsedTimer frame;
+    frame.start();
+    const qint64 budgetNs = qint64(m_budgetMs.loadRelaxed()) * 1000000;
+
+    while(!m_batch.isEmpty() && frame.nsecsElapsed() < budgetNs)
+    {
+        TaskWrapperBase* task = m_batch.dequeue();
+        task->run();
+        if(task->autoDelete())
+        {
+            delete task;
+        }
+    }
+
+    if(!m_batch.isEmpty())
+    {
+        requestDrain();
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef MAINTHREADDISPATCHER_H
+#define MAINTHREADDISPATCHER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QAtomicInt>
+
+class TaskWrapperBase;
+
+// Runs tasks on the thread this object lives in (the GUI thread). Posted
+// tasks are drained in batches once per event-loop iteration; a batch stops
+// when the frame budget is used up and the remainder carries over to the
+// next iteration, so input and paint events are never starved.
+class MainThreadDispatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MainThreadDispatcher(QObject* parent = nullptr);
+    ~MainThreadDispatcher();
+
+    void post(TaskWrapperBase* task);
+
+    void setFrameBudget(int budgetMs);
+    int frameBudget() const;
+
+protected:
+    bool event(QEvent* event) override;
+
+private:
+    void requestDrain();
+    void drain();
+
+    QMutex m_mutex;
+    QQueue<TaskWrapperBase*> m_pending;
+    QQueue<TaskWrapperBase*> m_batch;
+    QAtomicInt m_drainRequested{0};
+    QAtomicInt m_budgetMs{4};
+};
+
+#endif // MAINTHREADDISPATCHER_H
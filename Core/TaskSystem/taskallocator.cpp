@@ -0,0 +1,185 @@
+#include "taskallocator.h"
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QMutexLocker>
+#include <new>
+#include <vector>
+
+namespace
+{
+struct FreeSlot
+{
+    FreeSlot* next;
+};
+
+QAtomicInteger<quint64> s_requests{0};
+QAtomicInteger<quint64> s_slabAllocations{0};
+QAtomicInteger<quint64> s_fallbackAllocations{0};
+
+class SlotDepot
+{
+public:
+    ~SlotDepot()
+    {
+        for(void* slab : m_slabs)
+        {
+            ::operator delete(slab);
+        }
+    }
+
+    FreeSlot* takeBatch(std::size_t slotSize, int& count)
+    {
+        QMutexLocker lock(&m_mutex);
+        if(!m_head)
+        {
+            carveSlab(slotSize);
+        }
+
+        FreeSlot* head = m_head;
+        FreeSlot* tail = head;
+        count = 1;
+        while(count < TaskAllocator::TransferBatch && tail->next)
+        {
+            tail = tail->next;
+            ++count;
+        }
+        m_head = tail->next;
+        tail->next = nullptr;
+        return head;
+    }
+
+    void returnBatch(FreeSlot* head, FreeSlot* tail)
+    {
+        QMutexLocker lock(&m_mutex);
+        tail->next = m_head;
+        m_head = head;
+    }
+
+private:
+    void carveSlab(std::size_t slotSize)
+    {
+        char* slab = static_cast<char*>(::operator new(slotSize * TaskAllocator::SlotsPerSlab));
+        m_slabs.push_back(slab);
+
+        for(int i = TaskAllocator::SlotsPerSlab - 1; i >= 0; --i)
+        {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(slab + i * slotSize);
+            slot->next = m_head;
+            m_head = slot;
+        }
+        s_slabAllocations.fetchAndAddRelaxed(1);
+    }
+
+    QMutex m_mutex;
+    FreeSlot* m_head = nullptr;
+    std::vector<void*> m_slabs;
+};
+
+SlotDepot& depot(int sizeClass)
+{
+    static SlotDepot depots[TaskAllocator::SizeClassCount];
+    return depots[sizeClass];
+}
+
+struct ThreadCache
+{
+    FreeSlot* heads[TaskAllocator::SizeClassCount] = {};
+    int counts[TaskAllocator::SizeClassCount] = {};
+
+    ~ThreadCache()
+    {
+        for(int sizeClass = 0; sizeClass < TaskAllocator::SizeClassCount; ++sizeClass)
+        {
+            if(!heads[sizeClass])
+                continue;
+
+            FreeSlot* tail = heads[sizeClass];
+            while(tail->next)
+            {
+                tail = tail->next;
+            }
+            depot(sizeClass).returnBatch(heads[sizeClass], tail);
+        }
+    }
+};
+
+thread_local ThreadCache t_cache;
+}
+
+void* TaskAllocator::allocate(std::size_t size)
+{
+    s_requests.fetchAndAddRelaxed(1);
+
+    const int sizeClass = sizeClassFor(size);
+    if(sizeClass < 0)
+    {
+        s_fallbackAllocations.fetchAndAddRelaxed(1);
+        return ::operator new(size);
+    }
+
+    ThreadCache& cache = t_cache;
+    if(!cache.heads[sizeClass])
+    {
+        cache.heads[sizeClass] = depot(sizeClass).takeBatch(SlotSizes[sizeClass],
+                                                            cache.counts[sizeClass]);
+    }
+
+    FreeSlot* slot = cache.heads[sizeClass];
+    cache.heads[sizeClass] = slot->next;
+    --cache.counts[sizeClass];
+    return slot;
+}
+
+void TaskAllocator::deallocate(void* ptr, std::size_t size)
+{
+    if(!ptr)
+        return;
+
+    const int sizeClass = sizeClassFor(size);
+    if(sizeClass < 0)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    ThreadCache& cache = t_cache;
+    FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+    slot->next = cache.heads[sizeClass];
+    cache.heads[sizeClass] = slot;
+
+    // Pool threads free what the main thread allocates, so spill the
+    // surplus back to the depot once the local list grows too long.
+    if(++cache.counts[sizeClass] > ThreadCacheLimit)
+    {
+        FreeSlot* head = cache.heads[sizeClass];
+        FreeSlot* tail = head;
+        for(int i = 1; i < TransferBatch; ++i)
+        {
+            tail = tail->next;
+        }
+        cache.heads[sizeClass] = tail->next;
+        cache.counts[sizeClass] -= TransferBatch;
+        tail->next = nullptr;
+        depot(sizeClass).returnBatch(head, tail);
+    }
+}
+
+TaskAllocator::Stats TaskAllocator::stats()
+{
+    Stats result;
+    result.requests = s_requests.loadRelaxed();
+    result.slabAllocations = s_slabAllocations.loadRelaxed();
+    result.fallbackAllocations = s_fallbackAllocations.loadRelaxed();
+    return result;
+}
+
+int TaskAllocator::sizeClassFor(std::size_t size)
+{
+    for(int sizeClass = 0; sizeClass < SizeClassCount; ++sizeClass)
+    {
+        if(size <= SlotSizes[sizeClass])
+            return sizeClass;
+    }
+    return -1;
+}
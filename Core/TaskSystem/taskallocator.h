@@ -0,0 +1,37 @@
+#ifndef TASKALLOCATOR_H
+#define TASKALLOCATOR_H
+
+#include <QtGlobal>
+#include <cstddef>
+
+// Slab allocator for scheduler tasks. Requests are rounded up to a fixed
+// slot size class; freed slots go to a per-thread free list and are handed
+// back to a shared depot in batches, so steady-state scheduling never
+// reaches malloc. Requests larger than the biggest class fall back to
+// ::operator new.
+class TaskAllocator
+{
+public:
+    struct Stats
+    {
+        quint64 requests = 0;            // allocate() calls
+        quint64 slabAllocations = 0;     // slabs carved from the heap
+        quint64 fallbackAllocations = 0; // oversize requests served by the heap
+    };
+
+    static constexpr std::size_t SlotSizes[] = {128, 512, 2048};
+    static constexpr int SizeClassCount = sizeof(SlotSizes) / sizeof(SlotSizes[0]);
+    static constexpr int SlotsPerSlab = 64;
+    static constexpr int TransferBatch = 32;
+    static constexpr int ThreadCacheLimit = 2 * TransferBatch;
+
+    static void* allocate(std::size_t size);
+    static void deallocate(void* ptr, std::size_t size);
+
+    static Stats stats();
+
+private:
+    static int sizeClassFor(std::size_t size);
+};
+
+#endif // TASKALLOCATOR_H
@@ -4,24 +4,103 @@
 #include "Tasks/methodtask.h"
 #include "Tasks/atomicmethodtask.h"
 #include "Tasks/lambdatask.h"
+#include "Tasks/coroutinetask.h"
+#include "Coroutines/cotask.h"
+#include "mainthreaddispatcher.h"
+#include "../Utilities/Logger/logger.h"
 #include <QMap>
+#include <QHash>
 #include <QThreadPool>
 #include <QTimer>
+#include <QDeadlineTimer>
+#include <algorithm>
+#include <functional>
+#include <coroutine>
+#include <vector>
 
-class TaskScheduler : public QObject
+class TaskScheduler : public QObject, private TaskCompletionListener
 {
     Q_OBJECT
 public:
+    enum SchedulingMode
+    {
+        QueuePriority,          // hand tasks straight to QThreadPool's priority queue
+        EarliestDeadlineFirst   // admit tasks by deadline, keeping workers reserved for high priority
+    };
+
     explicit TaskScheduler(QObject* parent = nullptr)
-        : QObject(parent), m_pool(new QThreadPool(this))
+        : QObject(parent),
+        m_pool(new QThreadPool(this)),
+        m_mainThreadDispatcher(new MainThreadDispatcher(this))
     {
         m_pool->setMaxThreadCount(4);
     }
 
     ~TaskScheduler()
     {
-        qDeleteAll(m_mutexes);
-        qDeleteAll(m_repeatingTimers);
+        m_pool->waitForDone();
+        qDeleteAll(m_highPriorityQueue);
+        qDeleteAll(m_regularQueue);
+        qDeleteAll(m_resources);
+        for(const RepeatingTask& task : std::as_const(m_repeatingTasks))
+        {
+            delete task.timer;
+        }
+    }
+
+    void setSchedulingMode(SchedulingMode mode)
+    {
+        QMutexLocker lock(&m_queueMutex);
+        m_mode = mode;
+        if(m_mode == QueuePriority)
+        {
+            // Flushed tasks were never counted in m_running, so they must
+            // not report back to taskFinished()
+            for(TaskWrapperBase* task : m_highPriorityQueue)
+            {
+                task->setCompletionListener(nullptr);
+                m_pool->start(task, task->taskPriority());
+            }
+            for(TaskWrapperBase* task : m_regularQueue)
+            {
+                task->setCompletionListener(nullptr);
+                m_pool->start(task, task->taskPriority());
+            }
+            m_highPriorityQueue.clear();
+            m_regularQueue.clear();
+        }
+    }
+
+    SchedulingMode schedulingMode() const
+    {
+        QMutexLocker lock(&m_queueMutex);
+        return m_mode;
+    }
+
+    void setReservedHighPriorityWorkers(int count)
+    {
+        QMutexLocker lock(&m_queueMutex);
+        m_reservedWorkers = qBound(0, count, m_pool->maxThreadCount() - 1);
+        dispatchPendingLocked();
+    }
+
+    // Time the GUI thread may spend per event-loop iteration on
+    // scheduleMainThread() work before deferring the rest.
+    void setMainThreadFrameBudget(int budgetMs)
+    {
+        m_mainThreadDispatcher->setFrameBudget(budgetMs);
+    }
+
+    quint64 deadlineMisses(const QString& resourceKey) const
+    {
+        QMutexLocker lock(&m_queueMutex);
+        return m_deadlineMisses.value(resourceKey, 0);
+    }
+
+    QHash<QString, quint64> deadlineMisses() const
+    {
+        QMutexLocker lock(&m_queueMutex);
+        return m_deadlineMisses;
     }
 
     template<class Receiver, typename... Args>
@@ -31,11 +110,10 @@ public:
                   QThread::Priority priority = QThread::NormalPriority,
                   Args&&... args)
     {
-        QMutex* mutex = getResourceMutex(resourceKey);
         MethodTask<Receiver, Args...>* task = new MethodTask<Receiver, Args...>(
             receiver, method, priority, std::forward<Args>(args)...
             );
-        task->setMutex(mutex);
+        prepareTask(task, resourceKey, priority, defaultDeadline(priority));
         startTask(task, priority);
     }
 
@@ -47,11 +125,10 @@ public:
                         QThread::Priority priority = QThread::NormalPriority,
                         Args&&... args)
     {
-        QMutex* mutex = getResourceMutex(resourceKey);
         AtomicMethodTask<Receiver, Args...>* task = new AtomicMethodTask<Receiver, Args...>(
             flag, receiver, method, std::forward<Args>(args)...
             );
-        task->setMutex(mutex);
+        prepareTask(task, resourceKey, priority, defaultDeadline(priority));
         startTask(task, priority);
     }
 
@@ -63,49 +140,266 @@ public:
                            QThread::Priority priority = QThread::NormalPriority,
                            Args&&... args)
     {
+        // A second registration replaces the first, whose timer would
+        // otherwise keep firing out of reach of setRepeatingInterval()
+        if(m_repeatingTasks.contains(resourceKey))
+        {
+            LOG_WARNING("Scheduler", "Repeating task %1 registered again, replacing it", resourceKey);
+            cancelRepeating(resourceKey);
+        }
+
         QTimer* timer = new QTimer(this);
         timer->setInterval(intervalMs);
 
-        connect(timer, &QTimer::timeout, this, [=]
-                {
-                    this->schedule(resourceKey, receiver, method, priority, std::forward<Args>(args)...);
-                });
+        RepeatingTask task;
+        task.timer = timer;
+        task.fire = [=]
+        {
+            this->schedule(resourceKey, receiver, method, priority, std::forward<Args>(args)...);
+        };
+        connect(timer, &QTimer::timeout, this, task.fire);
+        m_repeatingTasks.insert(resourceKey, task);
 
         timer->start();
     }
+
+    // GUI thread: stops a scheduleRepeating() task; runs already scheduled
+    // still complete
+    void cancelRepeating(const QString& resourceKey)
+    {
+        auto it = m_repeatingTasks.find(resourceKey);
+        if(it == m_repeatingTasks.end())
+            return;
+
+        // May be called from the timer's own timeout
+        it->timer->stop();
+        it->timer->deleteLater();
+        m_repeatingTasks.erase(it);
+    }
+
+    // GUI thread: changes the period of a scheduleRepeating() task
+    void setRepeatingInterval(const QString& resourceKey, int intervalMs)
+    {
+        auto it = m_repeatingTasks.constFind(resourceKey);
+        if(it != m_repeatingTasks.constEnd() && it->timer->interval() != intervalMs)
+        {
+            it->timer->start(qMax(1, intervalMs));
+        }
+    }
+
+    // GUI thread: runs a scheduleRepeating() task now and restarts its period
+    void triggerRepeating(const QString& resourceKey)
+    {
+        auto it = m_repeatingTasks.constFind(resourceKey);
+        if(it != m_repeatingTasks.constEnd())
+        {
+            it->timer->start();
+            it->fire();
+        }
+    }
     template<typename Functor>
     void scheduleMainThread(const QString& resourceKey,
                             Functor&& func,
                             QThread::Priority priority = QThread::NormalPriority)
     {
-        QMutex* mutex = getResourceMutex(resourceKey);
         LambdaTask<Functor>* task = new LambdaTask<Functor>(std::forward<Functor>(func));
-        task->setMutex(mutex);
-        QMetaObject::invokeMethod(this, [this, task, priority]() {
-            startTask(task, priority);
-        }, Qt::QueuedConnection);
+        prepareTask(task, resourceKey, priority, defaultDeadline(priority));
+        m_mainThreadDispatcher->post(task);
+    }
+
+    // Awaitables for CoTask coroutines. onPool() continues on a worker while
+    // holding the resource key's mutex until the next suspension point;
+    // onMainThread() and after() continue on the scheduler's (GUI) thread.
+    auto onPool(const QString& resourceKey, QThread::Priority priority = QThread::NormalPriority)
+    {
+        struct PoolAwaiter
+        {
+            TaskScheduler* scheduler;
+            QString resourceKey;
+            QThread::Priority priority;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                CoroutineTask* task = new CoroutineTask(handle);
+                scheduler->prepareTask(task, resourceKey, priority, defaultDeadline(priority));
+                scheduler->startTask(task, priority);
+            }
+            void await_resume() const noexcept {}
+        };
+        return PoolAwaiter{this, resourceKey, priority};
+    }
+
+    auto onMainThread()
+    {
+        struct MainThreadAwaiter
+        {
+            TaskScheduler* scheduler;
+
+            bool await_ready() const noexcept { return QThread::currentThread() == scheduler->thread(); }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                scheduler->m_mainThreadDispatcher->post(new CoroutineTask(handle));
+            }
+            void await_resume() const noexcept {}
+        };
+        return MainThreadAwaiter{this};
+    }
+
+    auto after(int delayMs)
+    {
+        struct DelayAwaiter
+        {
+            TaskScheduler* scheduler;
+            int delayMs;
+
+            bool await_ready() const noexcept { return delayMs <= 0 && QThread::currentThread() == scheduler->thread(); }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                TaskScheduler* target = scheduler;
+                const int delay = delayMs;
+                QMetaObject::invokeMethod(target, [target, handle, delay]() {
+                    QTimer::singleShot(delay, target, [target, handle]() {
+                        target->m_mainThreadDispatcher->post(new CoroutineTask(handle));
+                    });
+                }, Qt::QueuedConnection);
+            }
+            void await_resume() const noexcept {}
+        };
+        return DelayAwaiter{this, delayMs};
     }
 
 private:
+    struct DeadlineLater
+    {
+        bool operator()(const TaskWrapperBase* a, const TaskWrapperBase* b) const
+        {
+            return a->deadline() > b->deadline();
+        }
+    };
+
+    // Soft targets that order the EDF queues; a miss is only counted
+    static constexpr int HIGH_PRIORITY_DEADLINE_MS = 16;// one frame
+    static constexpr int NORMAL_PRIORITY_DEADLINE_MS = 100;
+    static constexpr int LOW_PRIORITY_DEADLINE_MS = 1000;
+
+    static QDeadlineTimer defaultDeadline(QThread::Priority priority)
+    {
+        if(priority >= QThread::HighPriority)
+            return QDeadlineTimer(HIGH_PRIORITY_DEADLINE_MS);
+        if(priority >= QThread::NormalPriority)
+            return QDeadlineTimer(NORMAL_PRIORITY_DEADLINE_MS);
+        return QDeadlineTimer(LOW_PRIORITY_DEADLINE_MS);
+    }
+
+    void prepareTask(TaskWrapperBase* task, const QString& resourceKey,
+                     QThread::Priority priority, QDeadlineTimer deadline)
+    {
+        ResourceSlot* resource = getResource(resourceKey);
+        task->setMutex(&resource->mutex);
+        task->setResourceKey(resourceKey);
+        task->setTaskPriority(priority);
+        task->setDeadline(deadline);
+        TASK_METRICS(task->markEnqueued(resource->metricsKey);)
+    }
+
     void startTask(TaskWrapperBase* task, QThread::Priority priority)
     {
-        m_pool->start(task, priority);
+        QMutexLocker lock(&m_queueMutex);
+        if(m_mode == QueuePriority)
+        {
+            m_pool->start(task, priority);
+            return;
+        }
+
+        task->setCompletionListener(this);
+        std::vector<TaskWrapperBase*>& queue = priority >= QThread::HighPriority
+                                                   ? m_highPriorityQueue
+                                                   : m_regularQueue;
+        queue.push_back(task);
+        std::push_heap(queue.begin(), queue.end(), DeadlineLater{});
+        dispatchPendingLocked();
+    }
+
+    // High-priority tasks may use every worker; everything else is capped
+    // so that m_reservedWorkers stay free for them. Among the admissible
+    // queue heads the earliest deadline wins.
+    void dispatchPendingLocked()
+    {
+        const int maxWorkers = m_pool->maxThreadCount();
+        while(true)
+        {
+            const bool highReady = !m_highPriorityQueue.empty() && m_running < maxWorkers;
+            const bool regularReady = !m_regularQueue.empty() &&
+                                      m_running < maxWorkers - m_reservedWorkers;
+            if(!highReady && !regularReady)
+                break;
+
+            bool takeHigh = highReady;
+            if(highReady && regularReady)
+            {
+                takeHigh = !DeadlineLater{}(m_highPriorityQueue.front(), m_regularQueue.front());
+            }
+
+            std::vector<TaskWrapperBase*>& queue = takeHigh ? m_highPriorityQueue : m_regularQueue;
+            std::pop_heap(queue.begin(), queue.end(), DeadlineLater{});
+            TaskWrapperBase* task = queue.back();
+            queue.pop_back();
+
+            ++m_running;
+            m_pool->start(task, task->taskPriority());
+        }
+    }
+
+    void taskFinished(TaskWrapperBase* task) override
+    {
+        QMutexLocker lock(&m_queueMutex);
+        --m_running;
+        // Counted per key for the metrics panel; logging every miss would
+        // flood the log from the scheduler itself under load
+        if(task->deadline().hasExpired())
+        {
+            ++m_deadlineMisses[task->resourceKey()];
+        }
+        dispatchPendingLocked();
     }
 
-    QMutex* getResourceMutex(const QString& key)
+    struct ResourceSlot
+    {
+        QMutex mutex;
+        int metricsKey = -1;
+    };
+
+    ResourceSlot* getResource(const QString& key)
     {
         QMutexLocker lock(&m_mapMutex);
-        if(!m_mutexes.contains(key))
+        ResourceSlot*& resource = m_resources[key];
+        if(!resource)
         {
-            m_mutexes[key] = new QMutex();
+            resource = new ResourceSlot();
+            TASK_METRICS(resource->metricsKey = TaskMetrics::registerResourceKey(key);)
         }
-        return m_mutexes[key];
+        return resource;
     }
 
     QThreadPool* m_pool;
-    QMap<QString, QMutex*> m_mutexes;
+    MainThreadDispatcher* m_mainThreadDispatcher;
+    QMap<QString, ResourceSlot*> m_resources;
     QMutex m_mapMutex;
-    QList<QTimer*> m_repeatingTimers;
+    struct RepeatingTask
+    {
+        QTimer* timer = nullptr;
+        std::function<void()> fire;
+    };
+    QHash<QString, RepeatingTask> m_repeatingTasks;
+
+    SchedulingMode m_mode = QueuePriority;
+    int m_reservedWorkers = 1;
+    int m_running = 0;
+    std::vector<TaskWrapperBase*> m_highPriorityQueue;
+    std::vector<TaskWrapperBase*> m_regularQueue;
+    QHash<QString, quint64> m_deadlineMisses;
+    mutable QMutex m_queueMutex;
 };
 
 #endif // TASKSCHEDULER_H
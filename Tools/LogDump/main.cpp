@@ -0,0 +1,149 @@
+#include "binarylog.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+namespace
+{
+struct Session
+{
+    qint64 anchorEpochMs = 0;
+    qint64 anchorNs = 0;
+    QHash<quint16, QString> categories;
+    QHash<quint16, QString> formats;
+};
+
+bool readSessionHeader(QDataStream& in, Session& session)
+{
+    char magic[sizeof(BinaryLog::Magic)];
+    if(in.readRawData(magic, sizeof(magic)) != int(sizeof(magic)) ||
+        std::memcmp(magic, BinaryLog::Magic, sizeof(magic)) != 0)
+    {
+        return false;
+    }
+
+    session = Session();
+    in >> session.anchorEpochMs >> session.anchorNs;
+    return in.status() == QDataStream::Ok;
+}
+
+// Accepts the active segment (app.blog) as well as rotated archives,
+// which are compressed with qCompress and carry a ".z" suffix.
+bool dumpFile(const QString& path, QTextStream& out, QTextStream& err)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        err << "Cannot open " << path << ": " << file.errorString() << Qt::endl;
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    if(path.endsWith(".z"))
+    {
+        data = qUncompress(data);
+    }
+
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    Session session;
+    if(!readSessionHeader(in, session))
+    {
+        err << path << " is not a ugnsm binary log" << Qt::endl;
+        return false;
+    }
+
+    QByteArray payload;
+    while(!in.atEnd())
+    {
+        // A new session starts with the magic instead of an entry type
+        char peek = 0;
+        if(buffer.peek(&peek, 1) == 1 && peek == BinaryLog::Magic[0])
+        {
+            if(!readSessionHeader(in, session))
+                break;
+            continue;
+        }
+
+        quint8 type;
+        in >> type;
+        if(type == 0)
+        {
+            // Preallocated tail of a segment that was not closed cleanly
+            break;
+        }
+        else if(type == BinaryLog::CategoryEntry || type == BinaryLog::FormatEntry)
+        {
+            quint16 id;
+            QByteArray text;
+            in >> id >> text;
+            (type == BinaryLog::CategoryEntry ? session.categories : session.formats)
+                .insert(id, QString::fromUtf8(text));
+        }
+        else if(type == BinaryLog::RecordEntry)
+        {
+            qint64 timestampNs;
+            quint8 kind, level;
+            quint16 categoryId, formatId, size;
+            in >> timestampNs >> kind >> level >> categoryId >> formatId >> size;
+
+            payload.resize(size);
+            if(in.readRawData(payload.data(), size) != size)
+                break;
+
+            const qint64 epochMs = session.anchorEpochMs + (timestampNs - session.anchorNs) / 1000000;
+            if(kind == BinaryLog::TextRecord)
+            {
+                const QStringList textArgs = BinaryLog::decodeArgs(payload.constData(), size);
+                out << BinaryLog::formatLine(epochMs, level, textArgs.value(0), textArgs.value(1));
+            }
+            else
+            {
+                const QString format = session.formats.value(formatId, QString("<format %1>").arg(formatId));
+                out << BinaryLog::formatLine(epochMs, level,
+                                             session.categories.value(categoryId),
+                                             BinaryLog::formatMessage(format, payload.constData(), size));
+            }
+        }
+        else
+        {
+            err << path << ": corrupt entry at offset " << buffer.pos() - 1 << Qt::endl;
+            return false;
+        }
+
+        if(in.status() != QDataStream::Ok)
+            break;
+    }
+    return true;
+}
+}
+
+// Usage: ugnsm-logdump [file...], defaults to app.blog. Pass archived
+// segments oldest first to get one continuous log.
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList paths = app.arguments().mid(1);
+    if(paths.isEmpty())
+    {
+        paths << "app.blog";
+    }
+
+    int result = 0;
+    for(const QString& path : paths)
+    {
+        if(!dumpFile(path, out, err))
+        {
+            result = 1;
+        }
+    }
+    return result;
+}
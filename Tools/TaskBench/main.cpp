@@ -0,0 +1,161 @@
+#include "taskscheduler.h"
+#include "taskallocator.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+constexpr int DEFAULT_TASKS = 100000;
+constexpr int DEFAULT_BATCH = 64;
+constexpr int WARMUP_BATCHES = 16;
+constexpr int KEY_COUNT = 4;// one per pool worker, so tasks do not serialize on a key
+
+// Pool side of the benchmark: records how long each task waited between
+// schedule() and the start of its run
+class Probe
+{
+public:
+    Probe(const QElapsedTimer& clock, std::vector<qint64>& latencies)
+        : m_clock(clock),
+        m_latencies(latencies)
+    {
+    }
+
+    void run(qint64 scheduledAtNs)
+    {
+        const qint64 latency = m_clock.nsecsElapsed() - scheduledAtNs;
+        const int slot = m_next.fetchAndAddRelaxed(1);
+        if(slot < int(m_latencies.size()))
+            m_latencies[slot] = latency;
+        m_done.release();
+    }
+
+    void reset() { m_next.storeRelaxed(0); }
+    void wait(int tasks) { m_done.acquire(tasks); }
+
+private:
+    const QElapsedTimer& m_clock;
+    std::vector<qint64>& m_latencies;
+    QAtomicInt m_next{0};
+    QSemaphore m_done;
+};
+
+// Batches keep the pool busy without letting the queue grow unbounded,
+// which would measure queue length instead of scheduling overhead
+void runPass(TaskScheduler& scheduler, Probe& probe, const QElapsedTimer& clock,
+             const QStringList& keys, int tasks, int batch)
+{
+    probe.reset();
+    for(int done = 0; done < tasks; done += batch)
+    {
+        const int count = qMin(batch, tasks - done);
+        for(int i = 0; i < count; ++i)
+        {
+            scheduler.schedule(keys[(done + i) % keys.size()], &probe, &Probe::run,
+                               QThread::NormalPriority, clock.nsecsElapsed());
+        }
+        probe.wait(count);
+    }
+}
+
+qint64 percentile(const std::vector<qint64>& sorted, double p)
+{
+    if(sorted.empty())
+        return 0;
+    return sorted[qMin(sorted.size() - 1, std::size_t(p * sorted.size()))];
+}
+
+QString formatLatency(qint64 nanoseconds)
+{
+    if(nanoseconds >= 1000000)
+        return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 2);
+    if(nanoseconds >= 1000)
+        return QString("%1 us").arg(nanoseconds / 1e3, 0, 'f', 1);
+    return QString("%1 ns").arg(nanoseconds);
+}
+}
+
+// Usage: ugnsm-taskbench [tasks] [batch] [--edf]. A warm-up pass fills the
+// allocator's slabs and thread caches first; the measured pass then reports
+// schedule-to-run latency and TaskAllocator::stats() deltas per task. Exits
+// with 1 if the measured pass still had to carve slabs from the heap.
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QStringList args = app.arguments().mid(1);
+    const bool edf = args.removeAll("--edf") > 0;
+    const int tasks = qMax(1, args.value(0, QString::number(DEFAULT_TASKS)).toInt());
+    const int batch = qMax(1, args.value(1, QString::number(DEFAULT_BATCH)).toInt());
+
+    TaskScheduler scheduler;
+    if(edf)
+    {
+        scheduler.setSchedulingMode(TaskScheduler::EarliestDeadlineFirst);
+    }
+
+    QStringList keys;
+    for(int i = 0; i < KEY_COUNT; ++i)
+    {
+        keys << QString("bench_%1").arg(i);
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    std::vector<qint64> latencies(tasks);
+    Probe probe(clock, latencies);
+
+    runPass(scheduler, probe, clock, keys, qMin(tasks, batch * WARMUP_BATCHES), batch);
+
+    const TaskAllocator::Stats before = TaskAllocator::stats();
+    const qint64 startedAt = clock.nsecsElapsed();
+    runPass(scheduler, probe, clock, keys, tasks, batch);
+    const qint64 elapsedNs = clock.nsecsElapsed() - startedAt;
+    const TaskAllocator::Stats after = TaskAllocator::stats();
+
+    std::sort(latencies.begin(), latencies.end());
+    const quint64 requests = after.requests - before.requests;
+    const quint64 slabs = after.slabAllocations - before.slabAllocations;
+    const quint64 fallbacks = after.fallbackAllocations - before.fallbackAllocations;
+
+    out << QString("%1 tasks in batches of %2, %3 mode, %4 tasks/s")
+               .arg(tasks)
+               .arg(batch)
+               .arg(edf ? "EDF" : "queue priority")
+               .arg(qint64(tasks * 1e9 / qMax<qint64>(1, elapsedNs)))
+        << Qt::endl;
+    out << QString("Schedule-to-run: p50 %1, p90 %2, p99 %3, max %4")
+               .arg(formatLatency(percentile(latencies, 0.5)),
+                    formatLatency(percentile(latencies, 0.9)),
+                    formatLatency(percentile(latencies, 0.99)),
+                    formatLatency(latencies.back()))
+        << Qt::endl;
+    out << QString("Allocator per task: %1 requests, %2 slabs, %3 heap fallbacks (%4 slabs, %5 fallbacks in total)")
+               .arg(double(requests) / tasks, 0, 'f', 2)
+               .arg(double(slabs) / tasks, 0, 'f', 4)
+               .arg(double(fallbacks) / tasks, 0, 'f', 4)
+               .arg(slabs)
+               .arg(fallbacks)
+        << Qt::endl;
+    if(edf)
+    {
+        quint64 misses = 0;
+        for(quint64 count : scheduler.deadlineMisses())
+        {
+            misses += count;
+        }
+        out << QString("Deadline misses: %1").arg(misses) << Qt::endl;
+    }
+
+    const bool steady = slabs == 0 && fallbacks == 0;
+    out << (steady ? "Steady state: no task allocation reached the heap"
+                   : "Steady state: task allocations still reached the heap")
+        << Qt::endl;
+    return steady ? 0 : 1;
+}
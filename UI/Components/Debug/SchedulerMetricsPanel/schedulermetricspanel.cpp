@@ -0,0 +1,108 @@
+#include "schedulermetricspanel.h"
+
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTimer>
+
+#include "../Core/TaskSystem/taskscheduler.h"
+#include "../Core/TaskSystem/Metrics/taskmetrics.h"
+#include "../Core/TaskSystem/taskallocator.h"
+
+SchedulerMetricsPanel::SchedulerMetricsPanel(TaskScheduler* scheduler, QWidget* parent)
+    : QWidget(parent),
+    m_scheduler(scheduler),
+    m_table(new QTableWidget(this)),
+    m_allocatorLabel(new QLabel(this)),
+    m_refreshTimer(new QTimer(this))
+{
+    setupUI();
+    m_refreshTimer->setInterval(1000);
+    connect(m_refreshTimer, &QTimer::timeout, this, &SchedulerMetricsPanel::refresh);
+}
+
+void SchedulerMetricsPanel::refresh()
+{
+    const QList<TaskMetrics::KeySnapshot> keys = TaskMetrics::snapshot();
+    const QHash<QString, quint64> misses = m_scheduler ? m_scheduler->deadlineMisses()
+                                                       : QHash<QString, quint64>();
+
+    m_table->setRowCount(keys.size());
+    for(int row = 0; row < keys.size(); ++row)
+    {
+        const TaskMetrics::KeySnapshot& key = keys[row];
+        const QStringList cells =
+            {
+                key.resourceKey,
+                QString::number(key.tasks),
+                formatLatency(key.queueWait.percentile(0.5)),
+                formatLatency(key.queueWait.percentile(0.99)),
+                formatLatency(key.runTime.percentile(0.5)),
+                formatLatency(key.runTime.percentile(0.99)),
+                formatLatency(key.lockWait.percentile(0.99)),
+                QString::number(misses.value(key.resourceKey, 0))
+            };
+
+        for(int col = 0; col < cells.size(); ++col)
+        {
+            QTableWidgetItem* item = m_table->item(row, col);
+            if(!item)
+            {
+                item = new QTableWidgetItem();
+                m_table->setItem(row, col, item);
+            }
+            item->setText(cells[col]);
+        }
+    }
+
+    // Slabs should stop growing once scheduling reaches a steady state
+    const TaskAllocator::Stats allocator = TaskAllocator::stats();
+    m_allocatorLabel->setText(QString("Task allocator: %1 requests, %2 slabs, %3 heap fallbacks")
+                                  .arg(allocator.requests)
+                                  .arg(allocator.slabAllocations)
+                                  .arg(allocator.fallbackAllocations));
+}
+
+void SchedulerMetricsPanel::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void SchedulerMetricsPanel::hideEvent(QHideEvent* event)
+{
+    m_refreshTimer->stop();
+    QWidget::hideEvent(event);
+}
+
+void SchedulerMetricsPanel::setupUI()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    if(!TaskMetrics::isEnabled())
+    {
+        layout->addWidget(new QLabel("Task metrics are disabled in this build (UGNSM_TASK_METRICS=OFF)", this));
+    }
+
+    m_table->setColumnCount(8);
+    m_table->setHorizontalHeaderLabels({"Resource", "Tasks", "Wait p50", "Wait p99",
+                                        "Run p50", "Run p99", "Lock p99", "Missed"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    layout->addWidget(m_table);
+    layout->addWidget(m_allocatorLabel);
+}
+
+QString SchedulerMetricsPanel::formatLatency(qint64 nanoseconds)
+{
+    if(nanoseconds >= 1000000)
+        return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 2);
+    if(nanoseconds >= 1000)
+        return QString("%1 us").arg(nanoseconds / 1e3, 0, 'f', 1);
+    return QString("%1 ns").arg(nanoseconds);
+}
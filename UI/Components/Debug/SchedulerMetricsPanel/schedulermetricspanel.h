@@ -0,0 +1,34 @@
+#ifndef SCHEDULERMETRICSPANEL_H
+#define SCHEDULERMETRICSPANEL_H
+
+#include <QWidget>
+
+QT_FORWARD_DECLARE_CLASS(QTableWidget)
+QT_FORWARD_DECLARE_CLASS(QLabel)
+QT_FORWARD_DECLARE_CLASS(QTimer)
+class TaskScheduler;
+
+class SchedulerMetricsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SchedulerMetricsPanel(TaskScheduler* scheduler, QWidget* parent = nullptr);
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void setupUI();
+    static QString formatLatency(qint64 nanoseconds);
+
+    TaskScheduler* m_scheduler;
+    QTableWidget* m_table;
+    QLabel* m_allocatorLabel;
+    QTimer* m_refreshTimer;
+};
+
+#endif // SCHEDULERMETRICSPANEL_H
@@ -0,0 +1,442 @@
+#include "gridcanvasview.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QApplication>
+#include <QScrollBar>
+
+GridCanvasView::GridCanvasView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+{
+    setFrameShape(QFrame::NoFrame);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+    updateMetrics();
+}
+
+GridCanvasView::~GridCanvasView()
+{
+    for(Cell& cell : m_cells)
+    {
+        disconnect(cell.connection);
+    }
+}
+
+void GridCanvasView::setGridSize(int rows, int cols, int visibleRows)
+{
+    rows = qMax(0, rows);
+    cols = qMax(0, cols);
+    visibleRows = qBound(0, visibleRows, rows);
+
+    // The window keeps its cells; a column change only drops or adds the
+    // edge columns, and updateWindow() trims or extends the rows
+    if(cols != m_cols)
+    {
+        QVector<Cell> cells(m_windowRows * cols);
+        for(int localRow = 0; localRow < m_windowRows; ++localRow)
+        {
+            for(int col = 0; col < m_cols; ++col)
+            {
+                Cell& cell = m_cells[localRow * m_cols + col];
+                if(col < cols)
+                {
+                    cells[localRow * cols + col] = std::move(cell);
+                }
+                else
+                {
+                    disconnect(cell.connection);
+                }
+            }
+        }
+        m_cells = std::move(cells);
+        m_pressIndex = m_dropIndex = QPoint(-1, -1);
+        m_dragging = false;
+    }
+
+    m_rows = rows;
+    m_cols = cols;
+    m_visibleRows = visibleRows;
+
+    updateMetrics();
+    viewport()->update();
+}
+
+void GridCanvasView::updateCell(int row, int col, NetworkInfoModel* model)
+{
+    const QPoint index(row, col);
+    Cell* cell = cellAt(index);
+    if(!cell)
+        return;
+
+    if(cell->model != model)
+    {
+        disconnect(cell->connection);
+        cell->model = model;
+        cell->connection = {};
+
+        if(model)
+        {
+            if(m_labels[0].text().isEmpty())
+            {
+                for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+                {
+                    m_labels[field].setText(model->fieldLabel(NetworkInfoModel::Field(field)));
+                }
+            }
+
+            cell->connection = connect(model, &NetworkInfoModel::fieldsChanged,
+                                       this, [this, index](quint32 fields)
+                                       {
+                                           markFieldsDirty(index, fields);
+                                       });
+        }
+    }
+
+    cell->dirtyFields = (1u << NetworkInfoModel::FieldCount) - 1;
+    viewport()->update(cellRect(index));
+}
+
+void GridCanvasView::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(viewport());
+    const QRect dirty = event->rect();
+    painter.fillRect(dirty, palette().window());
+
+    if(m_cells.isEmpty())
+        return;
+
+    // Only visit the cells that intersect the invalidated area
+    const int offset = verticalScrollBar()->value();
+    const int stepX = m_cellSize.width() + CELL_SPACING;
+    const int lastWindowRow = m_firstRow + m_windowRows - 1;
+    const int firstRow = qBound(m_firstRow, (dirty.top() + offset - CELL_SPACING) / rowStep(), lastWindowRow);
+    const int lastRow = qBound(m_firstRow, (dirty.bottom() + offset - CELL_SPACING) / rowStep(), lastWindowRow);
+    const int firstCol = qBound(0, (dirty.left() - CELL_SPACING) / stepX, m_cols - 1);
+    const int lastCol = qBound(0, (dirty.right() - CELL_SPACING) / stepX, m_cols - 1);
+
+    for(int row = firstRow; row <= lastRow; ++row)
+    {
+        for(int col = firstCol; col <= lastCol; ++col)
+        {
+            const QPoint index(row, col);
+            if(cellRect(index).intersects(dirty))
+            {
+                paintCell(painter, dirty, index, *cellAt(index));
+            }
+        }
+    }
+}
+
+void GridCanvasView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateMetrics();
+}
+
+void GridCanvasView::changeEvent(QEvent* event)
+{
+    if(event->type() == QEvent::FontChange || event->type() == QEvent::PaletteChange)
+    {
+        updateMetrics();
+        viewport()->update();
+    }
+    QAbstractScrollArea::changeEvent(event);
+}
+
+// The bits that stay on screen are blitted; only the exposed strip is
+// repainted, and the cell window follows the scroll position.
+void GridCanvasView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    viewport()->scroll(0, dy);
+    if(m_dropIndex != QPoint(-1, -1))
+    {
+        setDropIndex(QPoint(-1, -1));
+    }
+    updateWindow();
+}
+
+void GridCanvasView::mousePressEvent(QMouseEvent* event)
+{
+    if(event->button() == Qt::LeftButton)
+    {
+        m_pressIndex = cellIndexAt(event->pos());
+        m_pressPos = event->pos();
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void GridCanvasView::mouseMoveEvent(QMouseEvent* event)
+{
+    if(!(event->buttons() & Qt::LeftButton) || m_pressIndex == QPoint(-1, -1))
+        return;
+
+    if(!m_dragging &&
+        (event->pos() - m_pressPos).manhattanLength() >= QApplication::startDragDistance())
+    {
+        m_dragging = true;
+        viewport()->setCursor(Qt::ClosedHandCursor);
+        viewport()->update(cellRect(m_pressIndex));
+    }
+
+    if(m_dragging)
+    {
+        setDropIndex(cellIndexAt(event->pos()));
+    }
+}
+
+void GridCanvasView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if(event->button() != Qt::LeftButton)
+        return;
+
+    if(m_dragging)
+    {
+        if(m_dropIndex != QPoint(-1, -1) && m_dropIndex != m_pressIndex)
+        {
+            emit cellSwapRequestToDataManager(m_pressIndex, m_dropIndex);
+        }
+        viewport()->unsetCursor();
+        viewport()->update(cellRect(m_pressIndex));
+        setDropIndex(QPoint(-1, -1));
+    }
+    m_dragging = false;
+    m_pressIndex = QPoint(-1, -1);
+}
+
+GridCanvasView::Cell* GridCanvasView::cellAt(const QPoint& index)
+{
+    const int localRow = index.x() - m_firstRow;
+    if(localRow < 0 || localRow >= m_windowRows || index.y() < 0 || index.y() >= m_cols)
+        return nullptr;
+    return &m_cells[localRow * m_cols + index.y()];
+}
+
+// In viewport coordinates
+QRect GridCanvasView::cellRect(const QPoint& index) const
+{
+    return QRect(CELL_SPACING + index.y() * (m_cellSize.width() + CELL_SPACING),
+                 CELL_SPACING + index.x() * rowStep() - verticalScrollBar()->value(),
+                 m_cellSize.width(), m_cellSize.height());
+}
+
+QRect GridCanvasView::fieldRect(const QPoint& index, int field) const
+{
+    const QRect cell = cellRect(index);
+    return QRect(cell.left() + CELL_PADDING, cell.top() + CELL_PADDING + field * m_lineHeight,
+                 cell.width() - 2 * CELL_PADDING, m_lineHeight);
+}
+
+void GridCanvasView::scrollToRow(int row)
+{
+    if(m_cellSize.isValid())
+    {
+        verticalScrollBar()->setValue(row * rowStep());
+    }
+}
+
+void GridCanvasView::contextMenuEvent(QContextMenuEvent* event)
+{
+    const QPoint index = cellIndexAt(event->pos());
+    if(index == QPoint(-1, -1))
+    {
+        QAbstractScrollArea::contextMenuEvent(event);
+        return;
+    }
+    emit cellContextMenuRequested(index, event->globalPos());
+    event->accept();
+}
+
+QPoint GridCanvasView::cellIndexAt(const QPoint& pos) const
+{
+    if(m_cells.isEmpty())
+        return QPoint(-1, -1);
+
+    const int col = (pos.x() - CELL_SPACING) / (m_cellSize.width() + CELL_SPACING);
+    const int row = (pos.y() + verticalScrollBar()->value() - CELL_SPACING) / rowStep();
+    const QPoint index(row, col);
+    if(row < m_firstRow || row >= m_firstRow + m_windowRows || col < 0 || col >= m_cols ||
+        !cellRect(index).contains(pos))
+        return QPoint(-1, -1);
+    return index;
+}
+
+void GridCanvasView::markFieldsDirty(const QPoint& index, quint32 fields)
+{
+    Cell* cell = cellAt(index);
+    if(!cell)
+        return;
+
+    cell->dirtyFields |= fields;
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+    {
+        if(fields & (1u << field))
+        {
+            viewport()->update(fieldRect(index, field));
+        }
+    }
+}
+
+void GridCanvasView::refreshCell(Cell& cell)
+{
+    if(!cell.dirtyFields || !cell.model)
+        return;
+
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+    {
+        if(!(cell.dirtyFields & (1u << field)))
+            continue;
+
+        const QString value = cell.model->fieldValue(NetworkInfoModel::Field(field));
+        if(value != cell.values[field])
+        {
+            cell.values[field] = value;
+            cell.valueTexts[field].setText(value);
+        }
+    }
+    cell.dirtyFields = 0;
+}
+
+void GridCanvasView::updateMetrics()
+{
+    m_lineHeight = fontMetrics().height() + 4;
+    if(m_rows == 0 || m_cols == 0 || m_visibleRows == 0)
+    {
+        m_cellSize = QSize();
+        verticalScrollBar()->setRange(0, 0);
+        updateWindow();
+        return;
+    }
+
+    // Cells are sized so that exactly visibleRows rows fit the viewport
+    const QSize area = viewport()->size();
+    const int width = (area.width() - CELL_SPACING * (m_cols + 1)) / m_cols;
+    const int height = (area.height() - CELL_SPACING * (m_visibleRows + 1)) / m_visibleRows;
+    m_cellSize = QSize(qMax(1, width), qMax(1, height));
+    m_labelWidth = (m_cellSize.width() - 2 * CELL_PADDING) * 2 / 5;
+
+    for(QStaticText& label : m_labels)
+    {
+        label.prepare(QTransform(), font());
+    }
+
+    const int contentHeight = CELL_SPACING + m_rows * rowStep();
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight - area.height()));
+    verticalScrollBar()->setPageStep(area.height());
+    verticalScrollBar()->setSingleStep(qMax(1, rowStep() / 4));
+    updateWindow();
+}
+
+// Moves the window of live cells to the rows intersecting the viewport.
+// Cells that stay inside keep their model binding and cached text.
+void GridCanvasView::updateWindow()
+{
+    int firstRow = 0;
+    int rowCount = 0;
+    if(m_cellSize.isValid() && m_cols > 0)
+    {
+        const int offset = verticalScrollBar()->value();
+        firstRow = qBound(0, offset / rowStep(), m_rows);
+        const int lastRow = qBound(0, (offset + viewport()->height()) / rowStep(), m_rows - 1);
+        rowCount = qMax(0, lastRow - firstRow + 1);
+    }
+
+    if(firstRow == m_firstRow && rowCount == m_windowRows)
+        return;
+
+    QVector<Cell> cells(rowCount * m_cols);
+    for(int localRow = 0; localRow < m_windowRows; ++localRow)
+    {
+        const int row = m_firstRow + localRow;
+        const bool kept = row >= firstRow && row < firstRow + rowCount;
+        for(int col = 0; col < m_cols; ++col)
+        {
+            Cell& cell = m_cells[localRow * m_cols + col];
+            if(kept)
+            {
+                cells[(row - firstRow) * m_cols + col] = std::move(cell);
+            }
+            else
+            {
+                disconnect(cell.connection);
+            }
+        }
+    }
+
+    m_cells = std::move(cells);
+    m_firstRow = firstRow;
+    m_windowRows = rowCount;
+    emit visibleRowsChanged(m_firstRow, m_windowRows);
+}
+
+void GridCanvasView::paintCell(QPainter& painter, const QRect& dirtyRect, const QPoint& index, Cell& cell)
+{
+    const QRect rect = cellRect(index);
+    const bool dragSource = m_dragging && index == m_pressIndex;
+    const bool dropTarget = index == m_dropIndex && index != m_pressIndex;
+
+    painter.save();
+    painter.setClipRect(rect.intersected(dirtyRect));
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(dropTarget ? QColor(100, 150, 250) : QColor(200, 200, 200), dropTarget ? 2 : 1));
+    painter.setBrush(palette().base());
+    painter.drawRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), 6, 6);
+
+    if(!cell.model)
+    {
+        painter.setPen(palette().color(QPalette::PlaceholderText));
+        painter.drawText(rect, Qt::AlignCenter, tr("No interface"));
+        painter.restore();
+        return;
+    }
+
+    refreshCell(cell);
+    painter.setOpacity(dragSource ? 0.4 : 1.0);
+
+    const QColor textColor = palette().color(QPalette::Text);
+    const QColor labelColor = palette().color(QPalette::PlaceholderText);
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+    {
+        const QRect line = fieldRect(index, field);
+        if(line.top() >= rect.bottom() - CELL_PADDING)
+            break;
+        if(!line.intersects(dirtyRect))
+            continue;
+
+        const int textTop = line.top() + (m_lineHeight - fontMetrics().height()) / 2;
+        painter.setPen(labelColor);
+        painter.drawStaticText(line.left(), textTop, m_labels[field]);
+
+        int valueLeft = line.left() + m_labelWidth;
+        if(field == NetworkInfoModel::StatusField)
+        {
+            const int led = fontMetrics().height() - 4;
+            const bool connected = cell.values[field] == QLatin1String("Connected");
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(connected ? QColor(Qt::green) : QColor(Qt::red));
+            painter.drawEllipse(QRect(valueLeft, line.center().y() - led / 2, led, led));
+            valueLeft += led + 6;
+        }
+        painter.setPen(textColor);
+        painter.drawStaticText(valueLeft, textTop, cell.valueTexts[field]);
+    }
+    painter.restore();
+}
+
+void GridCanvasView::setDropIndex(const QPoint& index)
+{
+    if(m_dropIndex == index)
+        return;
+
+    if(m_dropIndex != QPoint(-1, -1))
+    {
+        viewport()->update(cellRect(m_dropIndex));
+    }
+    m_dropIndex = index;
+    if(m_dropIndex != QPoint(-1, -1))
+    {
+        viewport()->update(cellRect(m_dropIndex));
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef GRIDCANVASVIEW_H
+#define GRIDCANVASVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QVector>
+#include <QPointer>
+#include <QStaticText>
+
+#include "../Core/Network/Information/networkinfomodel.h"
+
+// Paints every grid cell itself instead of hosting a NetworkInfoViewWidget
+// per cell. Text layout is cached per field in QStaticText and only the
+// rectangles of changed fields are invalidated.
+//
+// The viewport shows visibleRows rows and scrolls by pixel; per-cell state
+// only exists for the rows that currently intersect it.
+class GridCanvasView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit GridCanvasView(QWidget* parent = nullptr);
+    ~GridCanvasView();
+
+    void setGridSize(int rows, int cols, int visibleRows);
+    void updateCell(int row, int col, NetworkInfoModel* model);
+
+    int gridRows() const { return m_rows; }
+    int gridCols() const { return m_cols; }
+    int firstVisibleRow() const { return m_firstRow; }
+    int visibleRowCount() const { return m_windowRows; }
+    void scrollToRow(int row);
+
+signals:
+    void cellSwapRequestToDataManager(QPoint from, QPoint to);
+    void visibleRowsChanged(int firstRow, int rowCount);
+    void cellContextMenuRequested(QPoint indx, QPoint globalPos);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
+
+private:
+    struct Cell
+    {
+        QPointer<NetworkInfoModel> model;
+        QMetaObject::Connection connection;
+        quint32 dirtyFields = 0;
+        QString values[NetworkInfoModel::FieldCount];
+        QStaticText valueTexts[NetworkInfoModel::FieldCount];
+    };
+
+    Cell* cellAt(const QPoint& index);
+    QRect cellRect(const QPoint& index) const;
+    QRect fieldRect(const QPoint& index, int field) const;
+    QPoint cellIndexAt(const QPoint& pos) const;
+    void markFieldsDirty(const QPoint& index, quint32 fields);
+    void refreshCell(Cell& cell);
+    void updateMetrics();
+    void updateWindow();
+    int rowStep() const { return m_cellSize.height() + CELL_SPACING; }
+    void paintCell(QPainter& painter, const QRect& dirtyRect, const QPoint& index, Cell& cell);
+    void setDropIndex(const QPoint& index);
+
+    QVector<Cell> m_cells;// row-major, rows m_firstRow..m_firstRow + m_windowRows
+    int m_rows = 0;
+    int m_cols = 0;
+    int m_visibleRows = 0;
+    int m_firstRow = 0;
+    int m_windowRows = 0;
+
+    QStaticText m_labels[NetworkInfoModel::FieldCount];
+    QSize m_cellSize;
+    int m_lineHeight = 0;
+    int m_labelWidth = 0;
+
+    QPoint m_pressIndex = QPoint(-1, -1);
+    QPoint m_pressPos;
+    QPoint m_dropIndex = QPoint(-1, -1);
+    bool m_dragging = false;
+
+    static constexpr int CELL_SPACING = 10;
+    static constexpr int CELL_PADDING = 8;
+};
+
+#endif // GRIDCANVASVIEW_H
@@ -0,0 +1,108 @@
+#include "cellhighlightoverlay.h"
+
+#include <QPainter>
+#include <QEvent>
+
+#include "../../../../Utilities/Animation/animationclock.h"
+
+CellHighlightOverlay::CellHighlightOverlay(QWidget* cell)
+    : QWidget(cell)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setGeometry(cell->rect());
+    cell->installEventFilter(this);
+    hide();
+}
+
+CellHighlightOverlay::~CellHighlightOverlay()
+{
+    AnimationClock::instance().unsubscribe(this);
+}
+
+// Restarts the fade; repeated flashes within one fade just extend it
+void CellHighlightOverlay::flash()
+{
+    AnimationClock& clock = AnimationClock::instance();
+    m_flashStartMs = clock.elapsed();
+    m_flashLevel = 1.0;
+
+    if(!m_animating)
+    {
+        m_animating = true;
+        connect(&clock, &AnimationClock::tick, this, &CellHighlightOverlay::handleAnimationTick);
+        clock.subscribe(this);
+    }
+    syncVisibility();
+    update();
+}
+
+void CellHighlightOverlay::setDragOver(bool dragOver)
+{
+    if(m_dragOver == dragOver)
+        return;
+
+    m_dragOver = dragOver;
+    syncVisibility();
+    update();
+}
+
+void CellHighlightOverlay::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event)
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QRectF frame = QRectF(rect()).adjusted(1, 1, -1, -1);
+
+    if(m_flashLevel > 0)
+    {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(33, 150, 243, int(48 * m_flashLevel)));
+        painter.drawRoundedRect(frame, 6, 6);
+    }
+
+    if(m_dragOver)
+    {
+        painter.setBrush(QColor(0, 255, 0, 50));
+        painter.setPen(QPen(QColor(Qt::darkGreen), 2, Qt::DashLine));
+        painter.drawRoundedRect(frame, 6, 6);
+    }
+}
+
+bool CellHighlightOverlay::eventFilter(QObject* watched, QEvent* event)
+{
+    if(watched == parentWidget() && event->type() == QEvent::Resize)
+    {
+        setGeometry(parentWidget()->rect());
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void CellHighlightOverlay::handleAnimationTick(qint64 elapsedMs)
+{
+    m_flashLevel = 1.0 - qreal(elapsedMs - m_flashStartMs) / FLASH_DURATION_MS;
+    if(m_flashLevel <= 0)
+    {
+        m_flashLevel = 0;
+        m_animating = false;
+        disconnect(&AnimationClock::instance(), &AnimationClock::tick,
+                   this, &CellHighlightOverlay::handleAnimationTick);
+        AnimationClock::instance().unsubscribe(this);
+        syncVisibility();
+    }
+    update();
+}
+
+void CellHighlightOverlay::syncVisibility()
+{
+    const bool needed = m_dragOver || m_flashLevel > 0;
+    if(needed && isHidden())
+    {
+        show();
+        raise();
+    }
+    else if(!needed && !isHidden())
+    {
+        hide();
+    }
+}
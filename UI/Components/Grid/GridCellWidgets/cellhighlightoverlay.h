@@ -0,0 +1,37 @@
+#ifndef CELLHIGHLIGHTOVERLAY_H
+#define CELLHIGHLIGHTOVERLAY_H
+
+#include <QWidget>
+
+// Paint-only layer stacked above a cell's children. Draws the drop-target
+// frame and an update flash that fades out on the shared AnimationClock,
+// so neither ever touches dynamic properties or the style sheet. It is
+// hidden whenever there is nothing to draw.
+class CellHighlightOverlay : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CellHighlightOverlay(QWidget* cell);
+    ~CellHighlightOverlay();
+
+    void flash();
+    void setDragOver(bool dragOver);
+    qreal flashLevel() const { return m_flashLevel; }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void handleAnimationTick(qint64 elapsedMs);
+    void syncVisibility();
+
+    qint64 m_flashStartMs = 0;
+    qreal m_flashLevel = 0;
+    bool m_dragOver = false;
+    bool m_animating = false;
+
+    static constexpr int FLASH_DURATION_MS = 300;
+};
+
+#endif // CELLHIGHLIGHTOVERLAY_H
@@ -1,4 +1,5 @@
 #include "gridcellwidget.h"
+#include "cellhighlightoverlay.h"
 
 #include <QMouseEvent>
 #include <QDragEnterEvent>
@@ -8,7 +9,6 @@
 #include <QMimeData>
 #include <QApplication>
 #include <QDebug>
-#include <QStyle>
 
 GridCellWidget::GridCellWidget(QWidget* parent)
     :QFrame(parent)
@@ -65,8 +65,7 @@ void GridCellWidget::dragEnterEvent(QDragEnterEvent *event)
 {
     if(event->mimeData()->hasFormat("application/x-grid-index"))
     {
-        setProperty("dragOver", true);
-        style()->polish(this);
+        overlay()->setDragOver(true);
         event->acceptProposedAction();
     }
     QFrame::dragEnterEvent(event);
@@ -80,8 +79,7 @@ void GridCellWidget::dropEvent(QDropEvent *event)
         return;
     }
 
-    setProperty("dragOver", false);
-    style()->polish(this);
+    overlay()->setDragOver(false);
 
     QByteArray receivedData = event->mimeData()->data("application/x-grid-index");
     QDataStream stream(&receivedData, QIODevice::ReadOnly);
@@ -96,11 +94,24 @@ void GridCellWidget::dropEvent(QDropEvent *event)
 
 void GridCellWidget::dragLeaveEvent(QDragLeaveEvent *event)
 {
-    setProperty("dragOver", false);
-    style()->polish(this);
+    overlay()->setDragOver(false);
     QFrame::dragLeaveEvent(event);
 }
 
+void GridCellWidget::flashHighlight()
+{
+    overlay()->flash();
+}
+
+CellHighlightOverlay* GridCellWidget::overlay()
+{
+    if(!m_overlay)
+    {
+        m_overlay = new CellHighlightOverlay(this);
+    }
+    return m_overlay;
+}
+
 QPoint GridCellWidget::getGridIndex() const
 {
     return m_gridIndex;
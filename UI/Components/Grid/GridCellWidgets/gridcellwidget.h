@@ -7,6 +7,7 @@ QT_FORWARD_DECLARE_CLASS(QMouseEvent)
 QT_FORWARD_DECLARE_CLASS(QDragEnterEvent)
 QT_FORWARD_DECLARE_CLASS(QDropEvent)
 QT_FORWARD_DECLARE_CLASS(QDragLeaveEvent)
+class CellHighlightOverlay;
 
 class GridCellWidget : public QFrame
 {
@@ -20,6 +21,9 @@ public:
     QPoint getGridIndex() const;
     void setGridIndex(QPoint newGridIndex);
 
+    // Short fading highlight painted over the cell
+    void flashHighlight();
+
 signals:
     void swapRequested(QPoint source, QPoint target);
     void gridIndexChanged();
@@ -31,10 +35,13 @@ protected:
     virtual void dropEvent(QDropEvent* event) override;
     virtual void dragLeaveEvent(QDragLeaveEvent* event) override;
 
+    CellHighlightOverlay* overlay();
+
     const QSize m_widgetSize = QSize(400, 400);
     QPoint m_gridIndex;
     QPoint m_dragStartPos;
 private:
+    CellHighlightOverlay* m_overlay = nullptr;
     Q_PROPERTY(QPoint gridIndex READ getGridIndex WRITE setGridIndex NOTIFY gridIndexChanged FINAL)
 };
 
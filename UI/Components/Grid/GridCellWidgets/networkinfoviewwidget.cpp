@@ -11,12 +11,13 @@
 #include <QPainter>
 #include <QList>
 #include <QApplication>
-#include <QTimer>
 
 #include "../../../../Utilities/Delegates/ledindicatordelegate.h"
 #include "../../../../Utilities/LedIndicator/ledindicator.h"
+#include "../../../../Utilities/Sparkline/sparklinewidget.h"
 //#include "networkinfo.h"
 #include "../../../../Core/Network/Information/networkinfomodel.h"
+#include "../../../../Core/Network/Information/speedhistory.h"
 
 NetworkInfoViewWidget::NetworkInfoViewWidget(NetworkInfoModel *viewModel, QFrame *parent)
     : GridCellWidget(parent), m_viewModel(viewModel)
@@ -39,8 +40,8 @@ void NetworkInfoViewWidget::setViewModel(NetworkInfoModel* model)
     // Disconnect old model signals
     if (m_viewModel)
     {
-        disconnect(m_viewModel, &NetworkInfoModel::propertyChanged,
-                   this, &NetworkInfoViewWidget::updateProperty);
+        disconnect(m_viewModel, &NetworkInfoModel::fieldsChanged,
+                   this, &NetworkInfoViewWidget::updateFields);
         disconnect(m_viewModel, &NetworkInfoModel::nameChanged,
                    this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
         disconnect(m_viewModel, &NetworkInfoModel::macChanged,
@@ -49,8 +50,6 @@ void NetworkInfoViewWidget::setViewModel(NetworkInfoModel* model)
                    this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
         disconnect(m_viewModel, &NetworkInfoModel::netmaskChanged,
                    this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
-        disconnect(m_viewModel, &NetworkInfoModel::speedChanged,
-                   this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
     }
 
     m_viewModel = model;
@@ -58,8 +57,8 @@ void NetworkInfoViewWidget::setViewModel(NetworkInfoModel* model)
     // Connect new model signals
     if (m_viewModel)
     {
-        connect(m_viewModel, &NetworkInfoModel::propertyChanged,
-                this, &NetworkInfoViewWidget::updateProperty);
+        connect(m_viewModel, &NetworkInfoModel::fieldsChanged,
+                this, &NetworkInfoViewWidget::updateFields);
         connect(m_viewModel, &NetworkInfoModel::nameChanged,
                 this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
         connect(m_viewModel, &NetworkInfoModel::macChanged,
@@ -68,8 +67,6 @@ void NetworkInfoViewWidget::setViewModel(NetworkInfoModel* model)
                 this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
         connect(m_viewModel, &NetworkInfoModel::netmaskChanged,
                 this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
-        connect(m_viewModel, &NetworkInfoModel::speedChanged,
-                this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
     }
 
     // Full UI refresh
@@ -78,55 +75,47 @@ void NetworkInfoViewWidget::setViewModel(NetworkInfoModel* model)
 
 const NetworkInfoModel *NetworkInfoViewWidget::getModel() const
 {
-    return m_viewModel ? m_viewModel : nullptr;
+    return m_viewModel;
 }
 
-void NetworkInfoViewWidget::updateProperty(const QString &propertyName)
+// Applies one coalesced batch of field changes with a single highlight
+// flash; only the changed rows are invalidated.
+void NetworkInfoViewWidget::updateFields(quint32 fields)
 {
-    if (!m_viewModel)
+    if (!m_viewModel || !fields)
         return;
 
-    setUpdatesEnabled(false);
-
-    const QString displayName = m_viewModel->propertyMap().key(propertyName);
-    const QPair<QString, QString> data = m_viewModel->getKeyValue(displayName);
-
-    for (int row = 0; row < keyValModel->rowCount(); ++row)
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
     {
-        QStandardItem* paramItem = keyValModel->item(row, 0);
-        if (paramItem->text() == data.first)
+        if(fields & (1u << field))
         {
-            QStandardItem* valueItem = keyValModel->item(row, 1);
-            valueItem->setText(data.second);
-
-            QStandardItem* statusItem = keyValModel->item(row, 2);
-            updateStatusIndicator(statusItem, data.first, data.second);
-
-            break;
+            updateFieldRow(NetworkInfoModel::Field(field));
         }
     }
 
-    if (propertyName == "downloadSpeed" ||
-        propertyName == "uploadSpeed" ||
-        propertyName == "totalSpeed")
+    if(fields & ((1u << NetworkInfoModel::DownloadSpeedField) | (1u << NetworkInfoModel::UploadSpeedField)))
     {
-        updateSpeedIndicators();
+        appendSparklineSamples();
     }
 
-    setProperty("updating", true);
-    QTimer::singleShot(150, this, [this]()
-                       {
-                           setProperty("updating", false);
-                           //style()->unpolish(this);
-                           style()->polish(this);
-                       });
+    flashHighlight();
+}
+
+void NetworkInfoViewWidget::updateFieldRow(NetworkInfoModel::Field field)
+{
+    const FieldRow& row = m_fieldRows[field];
+    const QString value = m_viewModel->fieldValue(field);
+    row.value->setText(value);
 
-    setUpdatesEnabled(true);
+    if(field == NetworkInfoModel::StatusField)
+    {
+        row.status->setData(value == QLatin1String("Connected") ? 1 : 0, Qt::UserRole);
+    }
 }
 
 QString NetworkInfoViewWidget::getMac() const
 {
-    return m_viewModel->getMac();
+    return m_viewModel ? m_viewModel->getMac() : QString();
 }
 
 void NetworkInfoViewWidget::updateNetworkInfoDisplay()
@@ -134,37 +123,22 @@ void NetworkInfoViewWidget::updateNetworkInfoDisplay()
     if(!m_viewModel)
         return;
 
-    setUpdatesEnabled(false);
-    keyValueTbl->setUpdatesEnabled(false);
-
-    QList<QPair<QString, QString>> currentData = m_viewModel->getAllKeyValuesAsList();
-
-    for(int row = 0; row < keyValModel->rowCount(); ++row)
+    // Labels are the same for every model, so they are filled in once
+    if(!m_labelsSet)
     {
-        QStandardItem* paramItem = keyValModel->item(row, 0);
-        QStandardItem* valueItem = keyValModel->item(row, 1);
-        QStandardItem* statusItem = keyValModel->item(row, 2);
-
-        auto it = std::find_if(currentData.begin(), currentData.end(),
-                               [&](const QPair<QString, QString>& item)
-                               {
-                                   return item.first == paramItem->text();
-                               });
-
-        if(it != currentData.end())
-        {
-            valueItem->setText(it->second);
-            updateStatusIndicator(statusItem, it->first, it->second);
-            currentData.erase(it);
-        }
-        else
+        for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
         {
-            keyValModel->removeRow(row--);
+            m_fieldRows[field].label->setText(m_viewModel->fieldLabel(NetworkInfoModel::Field(field)));
         }
+        m_labelsSet = true;
+    }
+
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+    {
+        updateFieldRow(NetworkInfoModel::Field(field));
     }
+    reloadSparkline();
     //resizeKeyValTable();
-    setUpdatesEnabled(true);
-    keyValueTbl->setUpdatesEnabled(true);
 }
 
 // void NetworkInfoViewWidget::dragEnterEvent(QDragEnterEvent* event)
@@ -211,26 +185,54 @@ void NetworkInfoViewWidget::updateNetworkInfoDisplay()
 //     event->ignore();
 // }
 
-void NetworkInfoViewWidget::addKeyValue(QPair<QString, QString> keyVal)
+// The history lives in NetworkInfo, so a rebound or re-created widget
+// picks up the full window again
+void NetworkInfoViewWidget::reloadSparkline()
 {
-    QList<QStandardItem*> newRow;
-    newRow << new QStandardItem(keyVal.first)
-           << new QStandardItem(keyVal.second);
+    const SpeedHistory& history = m_viewModel->speedHistory();
+    const quint64 count = history.sampleCount();
 
-    QStandardItem *ledItem = new QStandardItem();
+    QVector<SparklineWidget::Sample> samples;
+    samples.reserve(int(count - history.firstAvailable()));
+    for(quint64 sequence = history.firstAvailable(); sequence < count; ++sequence)
+    {
+        const SpeedHistory::Sample sample = history.sample(sequence);
+        samples.append({qreal(sample.rx), qreal(sample.tx)});
+    }
+    m_sparkline->setSamples(samples);
+    m_historySequence = count;
+}
 
-    if(keyVal.first == "Is Up:" || keyVal.first == "Is Running:")
+// Usually exactly one new sample per frame
+void NetworkInfoViewWidget::appendSparklineSamples()
+{
+    const SpeedHistory& history = m_viewModel->speedHistory();
+    const quint64 count = history.sampleCount();
+    if(m_historySequence > count || m_historySequence < history.firstAvailable())
     {
-        bool state = (keyVal.second.compare("True", Qt::CaseInsensitive) == 0);
-        ledItem->setData(state ? 1 : 0, Qt::UserRole); // 1=green, 0=red
+        reloadSparkline();
+        return;
     }
-    else
+
+    for(; m_historySequence < count; ++m_historySequence)
     {
-        ledItem->setData(-1, Qt::UserRole);
+        const SpeedHistory::Sample sample = history.sample(m_historySequence);
+        m_sparkline->appendSample({qreal(sample.rx), qreal(sample.tx)});
     }
+}
 
-    newRow << ledItem;
-    keyValModel->appendRow(newRow);
+// The rows are fixed; only the item texts change when models are rebound
+void NetworkInfoViewWidget::buildFieldRows()
+{
+    for(int field = 0; field < NetworkInfoModel::FieldCount; ++field)
+    {
+        FieldRow& row = m_fieldRows[field];
+        row.label = new QStandardItem();
+        row.value = new QStandardItem();
+        row.status = new QStandardItem();
+        row.status->setData(-1, Qt::UserRole);// 1=green, 0=red, -1=none
+        keyValModel->appendRow({row.label, row.value, row.status});
+    }
 }
 
 void NetworkInfoViewWidget::setupTableView()
@@ -252,7 +254,7 @@ void NetworkInfoViewWidget::setupTableView()
     //keyValueTbl->setDropIndicatorShown(true);
     //keyValueTbl->setDragDropMode(QAbstractItemView::InternalMove);
     //keyValueTbl->setSelectionMode(QAbstractItemView::NoSelection);
-    setKeyValueTbl();
+    buildFieldRows();
     connectViewModel();
 
     keyValueTbl->viewport()->setAttribute(Qt::WA_TransparentForMouseEvents);
@@ -262,11 +264,14 @@ void NetworkInfoViewWidget::setupTableView()
 
 void NetworkInfoViewWidget::connectViewModel()
 {
+    if(!m_viewModel)
+        return;
+
+    connect(m_viewModel, &NetworkInfoModel::fieldsChanged, this, &NetworkInfoViewWidget::updateFields);
     connect(m_viewModel, &NetworkInfoModel::nameChanged, this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
     connect(m_viewModel, &NetworkInfoModel::macChanged, this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
     connect(m_viewModel, &NetworkInfoModel::ipAddressChanged, this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
     connect(m_viewModel, &NetworkInfoModel::netmaskChanged, this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
-    connect(m_viewModel, &NetworkInfoModel::speedChanged, this, &NetworkInfoViewWidget::updateNetworkInfoDisplay);
 }
 
 bool NetworkInfoViewWidget::eventFilter(QObject *watched, QEvent *event)
@@ -286,35 +291,6 @@ bool NetworkInfoViewWidget::eventFilter(QObject *watched, QEvent *event)
     return GridCellWidget::eventFilter(watched, event);
 }
 
-void NetworkInfoViewWidget::updateStatusIndicator(QStandardItem *item, const QString &key, const QString &value)
-{
-    if(key == "Is Up:" || key == "Is Running:")
-    {
-        bool state = (value.compare("True", Qt::CaseInsensitive) == 0);
-        item->setData(state ? 1 : 0, Qt::UserRole);
-    }
-    else
-    {
-        item->setData(-1, Qt::UserRole);
-    }
-}
-
-void NetworkInfoViewWidget::updateSpeedIndicators()
-{
-    QPair<QString, QString> rxSpeed = m_viewModel->getKeyValue("RX Speed");
-    QPair<QString, QString> txSpeed = m_viewModel->getKeyValue("TX Speed");
-
-    for(int row = 0; row < keyValModel->rowCount(); ++row)
-    {
-        QStandardItem* paramItem = keyValModel->item(row, 0);
-        if(paramItem->text() == "RX Speed" || paramItem->text() == "TX Speed")
-        {
-            QStandardItem* valueItem = keyValModel->item(row, 1);
-            valueItem->setText(paramItem->text() == "RX Speed" ? rxSpeed.second : txSpeed.second);
-        }
-    }
-}
-
 void NetworkInfoViewWidget::setupUI()
 {
     setAcceptDrops(true);
@@ -327,30 +303,11 @@ void NetworkInfoViewWidget::setupUI()
     // crownLbl.setFixedHeight(50);
     // layout()->addWidget(&crownLbl);
 
+    m_sparkline = new SparklineWidget(this);
+    layout()->addWidget(m_sparkline);
+
     layout()->setSpacing(0);
     keyValueTbl->viewport()->installEventFilter(this);
+    updateNetworkInfoDisplay();
 }
 
-void NetworkInfoViewWidget::setKeyValueTbl()
-{
-    if(m_viewModel)
-    {
-        for(const auto& keyVal : m_viewModel->getAllKeyValuesAsList())
-        {
-            addKeyValue(keyVal);
-        }
-    }
-}
-
-bool NetworkInfoViewWidget::isUpdating() const
-{
-    return m_updating;
-}
-
-void NetworkInfoViewWidget::setUpdating(bool newUpdating)
-{
-    if (m_updating == newUpdating)
-        return;
-    m_updating = newUpdating;
-    emit updatingChanged();
-}
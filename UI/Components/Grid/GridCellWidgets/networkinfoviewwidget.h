@@ -2,14 +2,16 @@
 #define NETWORKINFOVIEWWIDGET_H
 
 #include "gridcellwidget.h"
+#include "../../../../Core/Network/Information/networkinfomodel.h"
 
 #include <QFrame>
 #include <QLabel>
+#include <QPointer>
 
 QT_FORWARD_DECLARE_CLASS(QTableView)
 QT_FORWARD_DECLARE_CLASS(QStandardItemModel);
 QT_FORWARD_DECLARE_CLASS(QStandardItem)
-class NetworkInfoModel;
+class SparklineWidget;
 
 class NetworkInfoViewWidget: public GridCellWidget
 {
@@ -20,42 +22,45 @@ public:
 
     void setViewModel(NetworkInfoModel* model);//TODO:mb add Q_PROPERTY
     const NetworkInfoModel* getModel()const;
-    void updateProperty(const QString& propertyName);
+    void updateFields(quint32 fields);
     QString getMac() const;
-    Q_PROPERTY(bool updating READ isUpdating WRITE setUpdating NOTIFY updatingChanged)
-
-    bool isUpdating() const;
-    void setUpdating(bool newUpdating);
 
 public slots:
     void updateNetworkInfoDisplay();
-signals:
-    void updatingChanged();
 protected:
     bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
-    void updateStatusIndicator(QStandardItem* item, const QString& key,
-                               const QString& value);
+    // One table row per NetworkInfoModel::Field, in field order
+    struct FieldRow
+    {
+        QStandardItem* label = nullptr;
+        QStandardItem* value = nullptr;
+        QStandardItem* status = nullptr;
+    };
 
-    void updateSpeedIndicators();
+    void updateFieldRow(NetworkInfoModel::Field field);
+    void reloadSparkline();
+    void appendSparklineSamples();
     //void resizeKeyValTable();
     void setupUI();
-    void setKeyValueTbl();
-    void addKeyValue(QPair<QString, QString>);
+    void buildFieldRows();
     void setupTableView();
     void connectViewModel();
 
 
-    NetworkInfoModel* m_viewModel;
+    QPointer<NetworkInfoModel> m_viewModel;
 
     QTableView* keyValueTbl;
     QStandardItemModel* keyValModel;
+    FieldRow m_fieldRows[NetworkInfoModel::FieldCount];
+    bool m_labelsSet = false;
+    SparklineWidget* m_sparkline = nullptr;
+    quint64 m_historySequence = 0;// next SpeedHistory sample to plot
 
     QLabel crownLbl;
     const QColor m_normalBorder = QColor(200, 200, 200);
     const QColor m_dragBorder = QColor(100, 150, 250);
-    bool m_updating;
 };
 
 #endif // NETWORKINFOVIEWWIDGET_H
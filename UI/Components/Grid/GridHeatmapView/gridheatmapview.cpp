@@ -0,0 +1,180 @@
+#include "gridheatmapview.h"
+#include "../Utilities/Logger/logger.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QElapsedTimer>
+#include <QtMath>
+
+GridHeatmapView::GridHeatmapView(QWidget* parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    buildColorTable();
+}
+
+void GridHeatmapView::setSummaries(const QVector<GridDataManager::InterfaceSummary>& summaries)
+{
+    const bool relayout = summaries.size() != m_tiles.size();
+    m_tiles.resize(summaries.size());
+    for(int i = 0; i < summaries.size(); ++i)
+    {
+        const GridDataManager::InterfaceSummary& summary = summaries[i];
+        Tile& tile = m_tiles[i];
+        tile.index = summary.index;
+        tile.name = summary.name;
+        tile.rxSpeed = summary.rxSpeed;
+        tile.txSpeed = summary.txSpeed;
+        tile.isUp = summary.isUp;
+        tile.level = levelFor(summary.rxSpeed + summary.txSpeed);
+    }
+
+    if(relayout)
+    {
+        updateLayout();
+    }
+    update();
+}
+
+void GridHeatmapView::clear()
+{
+    m_tiles.clear();
+    update();
+}
+
+void GridHeatmapView::paintEvent(QPaintEvent* event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().window());
+
+    const QColor downColor = palette().color(QPalette::Dark);
+    for(int i = 0; i < m_tiles.size(); ++i)
+    {
+        const QRect rect = tileRect(i);
+        if(!rect.intersects(event->rect()))
+            continue;
+
+        const Tile& tile = m_tiles[i];
+        painter.fillRect(rect, tile.isUp ? m_colorTable[tile.level] : downColor);
+    }
+    painter.end();
+
+    m_lastPaintNs = timer.nsecsElapsed();
+    if(++m_paintCount % PAINT_LOG_INTERVAL == 0)
+    {
+        LOG_DEBUG("UI", "Heatmap paint: %1 tiles in %2 us", m_tiles.size(), m_lastPaintNs / 1000);
+    }
+}
+
+void GridHeatmapView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    updateLayout();
+}
+
+void GridHeatmapView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if(event->button() == Qt::LeftButton)
+    {
+        const int i = tileAt(event->position().toPoint());
+        if(i >= 0)
+        {
+            emit tileActivated(m_tiles[i].index);
+            return;
+        }
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+bool GridHeatmapView::event(QEvent* event)
+{
+    if(event->type() == QEvent::ToolTip)
+    {
+        QHelpEvent* help = static_cast<QHelpEvent*>(event);
+        const int i = tileAt(help->pos());
+        if(i < 0)
+        {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        const Tile& tile = m_tiles[i];
+        QToolTip::showText(help->globalPos(),
+                           QString("%1\n%2\nDownload: %3 B/s\nUpload: %4 B/s")
+                               .arg(tile.name, tile.isUp ? tr("Connected") : tr("Disconnected"))
+                               .arg(tile.rxSpeed)
+                               .arg(tile.txSpeed),
+                           this, tileRect(i));
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+// Cold to hot: dark blue through green and yellow to red
+void GridHeatmapView::buildColorTable()
+{
+    for(int i = 0; i < 256; ++i)
+    {
+        const double hue = (1.0 - i / 255.0) * 240.0 / 360.0;
+        m_colorTable[i] = QColor::fromHsvF(hue, 0.85, 0.45 + 0.5 * i / 255.0);
+    }
+}
+
+// Largest square tile that still fits every interface into the widget
+void GridHeatmapView::updateLayout()
+{
+    const int count = qMax<int>(1, m_tiles.size());
+    const int w = qMax(1, width());
+    const int h = qMax(1, height());
+
+    int size = qBound(MIN_TILE_SIZE, int(qSqrt(double(w) * h / count)) - TILE_SPACING, MAX_TILE_SIZE);
+    while(size > MIN_TILE_SIZE)
+    {
+        const int columns = qMax(1, w / (size + TILE_SPACING));
+        const int rows = (count + columns - 1) / columns;
+        if(rows * (size + TILE_SPACING) <= h)
+            break;
+        --size;
+    }
+
+    m_tileSize = size;
+    m_columns = qMax(1, w / (size + TILE_SPACING));
+    update();
+}
+
+int GridHeatmapView::tileAt(const QPoint& pos) const
+{
+    const int step = m_tileSize + TILE_SPACING;
+    if(pos.x() < 0 || pos.y() < 0 || pos.x() % step >= m_tileSize || pos.y() % step >= m_tileSize)
+        return -1;
+
+    const int col = pos.x() / step;
+    if(col >= m_columns)
+        return -1;
+
+    const int i = pos.y() / step * m_columns + col;
+    return i < m_tiles.size() ? i : -1;
+}
+
+QRect GridHeatmapView::tileRect(int i) const
+{
+    const int step = m_tileSize + TILE_SPACING;
+    return QRect((i % m_columns) * step, (i / m_columns) * step, m_tileSize, m_tileSize);
+}
+
+// Log scale so idle links and saturated ones are both distinguishable
+quint8 GridHeatmapView::levelFor(qint64 bytesPerSecond)
+{
+    if(bytesPerSecond <= 0)
+        return 0;
+
+    const double level = std::log2(double(bytesPerSecond) + 1.0) * 255.0 / MAX_LOG2_SPEED;
+    return quint8(qBound(0.0, level, 255.0));
+}
@@ -0,0 +1,67 @@
+#ifndef GRIDHEATMAPVIEW_H
+#define GRIDHEATMAPVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QColor>
+
+#include "../Core/Grid/Managment/griddatamanager.h"
+
+// Overview of every interface at once: one small tile per interface,
+// coloured by throughput, all painted with solid fills in a single pass.
+// Colours are resolved when the summaries arrive so paintEvent does no
+// per-tile work beyond a fillRect.
+class GridHeatmapView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit GridHeatmapView(QWidget* parent = nullptr);
+
+    void setSummaries(const QVector<GridDataManager::InterfaceSummary>& summaries);
+    void clear();
+
+    qint64 lastPaintNs() const { return m_lastPaintNs; }
+
+signals:
+    // Grid index of the clicked interface
+    void tileActivated(QPoint indx);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    bool event(QEvent* event) override;
+
+private:
+    struct Tile
+    {
+        QPoint index;
+        QString name;
+        qint64 rxSpeed = 0;
+        qint64 txSpeed = 0;
+        bool isUp = false;
+        quint8 level = 0;
+    };
+
+    void buildColorTable();
+    void updateLayout();
+    int tileAt(const QPoint& pos) const;
+    QRect tileRect(int i) const;
+    static quint8 levelFor(qint64 bytesPerSecond);
+
+    QVector<Tile> m_tiles;
+    QColor m_colorTable[256];
+    int m_columns = 1;
+    int m_tileSize = MAX_TILE_SIZE;
+
+    qint64 m_lastPaintNs = 0;
+    quint64 m_paintCount = 0;
+
+    static constexpr int MIN_TILE_SIZE = 6;
+    static constexpr int MAX_TILE_SIZE = 48;
+    static constexpr int TILE_SPACING = 1;
+    static constexpr int MAX_LOG2_SPEED = 30;// 1 GiB/s saturates the scale
+    static constexpr int PAINT_LOG_INTERVAL = 300;
+};
+
+#endif // GRIDHEATMAPVIEW_H
@@ -0,0 +1,74 @@
+#include "cellwidgetpool.h"
+#include "../GridCellWidgets/networkinfoviewwidget.h"
+#include "../GridCellWidgets/placeholdercellwidget.h"
+#include "../Core/Network/Information/networkinfomodel.h"
+
+CellWidgetPool::CellWidgetPool(QWidget* parent, int maxIdle)
+    : m_parent(parent),
+    m_maxIdle(maxIdle)
+{
+}
+
+CellWidgetPool::~CellWidgetPool()
+{
+    qDeleteAll(m_idleInfoWidgets);
+    qDeleteAll(m_idlePlaceholders);
+}
+
+NetworkInfoViewWidget* CellWidgetPool::acquireInfoWidget(NetworkInfoModel* model)
+{
+    if(!m_idleInfoWidgets.isEmpty())
+    {
+        NetworkInfoViewWidget* widget = m_idleInfoWidgets.takeLast();
+        widget->setViewModel(model);
+        ++m_reused;
+        return widget;
+    }
+
+    // Field updates reach the widget through NetworkInfoModel::fieldsChanged,
+    // which UiUpdateCoalescer publishes once per frame
+    NetworkInfoViewWidget* widget = new NetworkInfoViewWidget(model);
+    widget->setParent(m_parent);
+    ++m_created;
+    return widget;
+}
+
+PlaceHolderCellWidget* CellWidgetPool::acquirePlaceholder()
+{
+    if(!m_idlePlaceholders.isEmpty())
+    {
+        ++m_reused;
+        return m_idlePlaceholders.takeLast();
+    }
+
+    ++m_created;
+    return new PlaceHolderCellWidget(m_parent);
+}
+
+// The widget must already be out of any layout
+void CellWidgetPool::release(GridCellWidget* widget)
+{
+    if(!widget)
+        return;
+
+    widget->hide();
+    if(NetworkInfoViewWidget* infoWidget = qobject_cast<NetworkInfoViewWidget*>(widget))
+    {
+        // Drop the model so a hidden widget neither pins nor follows it
+        infoWidget->setViewModel(nullptr);
+        if(m_idleInfoWidgets.size() < m_maxIdle)
+        {
+            m_idleInfoWidgets.append(infoWidget);
+            return;
+        }
+    }
+    else if(PlaceHolderCellWidget* placeholder = qobject_cast<PlaceHolderCellWidget*>(widget))
+    {
+        if(m_idlePlaceholders.size() < m_maxIdle)
+        {
+            m_idlePlaceholders.append(placeholder);
+            return;
+        }
+    }
+    widget->deleteLater();
+}
@@ -0,0 +1,37 @@
+#ifndef CELLWIDGETPOOL_H
+#define CELLWIDGETPOOL_H
+
+#include <QVector>
+
+class QWidget;
+class GridCellWidget;
+class NetworkInfoViewWidget;
+class PlaceHolderCellWidget;
+class NetworkInfoModel;
+
+// Keeps released cell widgets hidden under their parent and hands them
+// out again, rebound to the new model, instead of building a new table
+// view, item model and delegate for every cell change.
+class CellWidgetPool
+{
+public:
+    explicit CellWidgetPool(QWidget* parent, int maxIdle = 64);
+    ~CellWidgetPool();
+
+    NetworkInfoViewWidget* acquireInfoWidget(NetworkInfoModel* model);
+    PlaceHolderCellWidget* acquirePlaceholder();
+    void release(GridCellWidget* widget);
+
+    int createdCount() const { return m_created; }
+    int reusedCount() const { return m_reused; }
+
+private:
+    QWidget* m_parent;
+    int m_maxIdle;
+    QVector<NetworkInfoViewWidget*> m_idleInfoWidgets;
+    QVector<PlaceHolderCellWidget*> m_idlePlaceholders;
+    int m_created = 0;
+    int m_reused = 0;
+};
+
+#endif // CELLWIDGETPOOL_H
@@ -11,14 +11,29 @@
 #include <QPainter>
 #include <QDebug>
 #include <QStyle>
+#include <QScrollBar>
+#include <QHBoxLayout>
+#include <QWheelEvent>
+#include <QContextMenuEvent>
 
 GridViewManager::GridViewManager(QWidget* parent)
     : QWidget(parent),
-    m_gridLayout(new QGridLayout(this))
+    m_gridContainer(new QWidget(this)),
+    m_gridLayout(new QGridLayout(m_gridContainer)),
+    m_scrollBar(new QScrollBar(Qt::Vertical, this)),
+    m_widgetPool(m_gridContainer)
 {
     m_gridLayout->setSpacing(10);
     m_gridLayout->setContentsMargins(10, 10, 10, 10);
-    setLayout(m_gridLayout);
+
+    QHBoxLayout* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    layout->addWidget(m_gridContainer, 1);
+    layout->addWidget(m_scrollBar);
+    m_scrollBar->hide();
+    connect(m_scrollBar, &QScrollBar::valueChanged, this, &GridViewManager::handleScroll);
+
     setAcceptDrops(true);
 }
 
@@ -27,55 +42,82 @@ GridViewManager::~GridViewManager()
     clearGrid();
 }
 
-void GridViewManager::setGridSize(int rows, int cols)
+void GridViewManager::setGridSize(int rows, int cols, int visibleRows)
 {
-    clearGrid();
-    m_cells.resize(rows);
+    visibleRows = qMin(visibleRows, rows);
+    m_totalRows = rows;
 
-    m_gridLayout->setSpacing(10);
-    m_gridLayout->setContentsMargins(10, 10, 10, 10);
-
-    for(int row = 0; row < rows; ++row)
+    // Growing or shrinking the grid only moves the scroll range. When the
+    // window itself changes shape only the edge rows and columns are
+    // released or added; the widgets that stay keep their model.
+    if(visibleRows != m_cells.size() || cols != gridCols())
     {
-        m_cells[row].resize(cols);
-        for(int col = 0; col < cols; ++col)
+        for(int row = visibleRows; row < m_cells.size(); ++row)
+        {
+            for(GridCellWidget* cell : std::as_const(m_cells[row]))
+            {
+                releaseCell(cell);
+            }
+        }
+        m_cells.resize(visibleRows);
+
+        for(int row = 0; row < visibleRows; ++row)
         {
-            PlaceHolderCellWidget* cell = new PlaceHolderCellWidget();
-            cell->setGridIndex(QPoint(row, col));
-            m_gridLayout->addWidget(cell, row, col, Qt::AlignCenter);
-            m_cells[row][col] = cell;
+            QVector<GridCellWidget*>& cells = m_cells[row];
+            for(int col = cols; col < cells.size(); ++col)
+            {
+                releaseCell(cells[col]);
+            }
+            const int oldCols = cells.size();
+            cells.resize(cols);
+            for(int col = oldCols; col < cols; ++col)
+            {
+                setCell(m_firstRow + row, col, m_widgetPool.acquirePlaceholder());
+            }
         }
     }
+
+    const QSignalBlocker blocker(m_scrollBar);
+    m_scrollBar->setRange(0, qMax(0, rows - visibleRows));
+    m_scrollBar->setPageStep(qMax(1, visibleRows));
+    m_scrollBar->setVisible(rows > visibleRows);
+    if(m_scrollBar->value() != m_firstRow)
+    {
+        handleScroll(m_scrollBar->value());
+    }
 }
 
 void GridViewManager::setCell(int row, int col, GridCellWidget* widget)
 {
-    if(row < 0 || row >= m_cells.size() || col < 0 || col >= m_cells[row].size())
+    const int localRow = row - m_firstRow;
+    if(localRow < 0 || localRow >= m_cells.size() || col < 0 || col >= m_cells[localRow].size())
         return;
 
-    GridCellWidget* oldWidget = m_cells[row][col];
+    GridCellWidget* oldWidget = m_cells[localRow][col];
+    if(oldWidget == widget)
+        return;
     if(oldWidget)
     {
+        if(oldWidget == m_highlightedCell)
+            clearHighlight();
         m_gridLayout->removeWidget(oldWidget);
-        oldWidget->deleteLater();
+        m_widgetPool.release(oldWidget);
     }
 
-
     widget->setGridIndex(QPoint(row, col));
     connect(widget, &GridCellWidget::swapRequested,
-            this, &GridViewManager::handleSwapRequested);
+            this, &GridViewManager::handleSwapRequested, Qt::UniqueConnection);
 
-    m_gridLayout->addWidget(widget, row, col);
-    m_cells[row][col] = widget;
+    m_gridLayout->addWidget(widget, localRow, col, Qt::AlignCenter);
+    m_cells[localRow][col] = widget;
+    widget->show();
 }
 
 void GridViewManager::updateCell(int row, int col, NetworkInfoModel* model)
 {
-    if (row < 0 || row >= gridRows() || col < 0 || col >= gridCols())
-        return;
-
     GridCellWidget* current = cellAt(row, col);
-    setUpdatesEnabled(false);
+    if (!current)
+        return;
 
     if (model)
     {
@@ -90,10 +132,8 @@ void GridViewManager::updateCell(int row, int col, NetworkInfoModel* model)
         }
         else
         {
-            // Replace placeholder with new NetworkInfoViewWidget
-            auto* newWidget = createCellWidgetForModel(model);
-            newWidget->setGridIndex(QPoint(row, col));
-            setCell(row, col, newWidget);
+            // Replace placeholder with a pooled NetworkInfoViewWidget
+            setCell(row, col, createCellWidgetForModel(model));
         }
     }
     else
@@ -101,12 +141,9 @@ void GridViewManager::updateCell(int row, int col, NetworkInfoModel* model)
         // Replace with placeholder if not already one
         if (!qobject_cast<PlaceHolderCellWidget*>(current))
         {
-            PlaceHolderCellWidget* placeholder = new PlaceHolderCellWidget(this);
-            placeholder->setGridIndex(QPoint(row, col));
-            setCell(row, col, placeholder);
+            setCell(row, col, m_widgetPool.acquirePlaceholder());
         }
     }
-    setUpdatesEnabled(true);
 }
 
 void GridViewManager::clearCell(int row, int col)
@@ -114,21 +151,70 @@ void GridViewManager::clearCell(int row, int col)
     if(auto* current = cellAt(row, col)) {
         if(current->metaObject()->className() != PlaceHolderCellWidget::staticMetaObject.className())
         {
-            setCell(row, col, new PlaceHolderCellWidget(this));
+            setCell(row, col, m_widgetPool.acquirePlaceholder());
         }
     }
 }
 
 GridCellWidget* GridViewManager::cellAt(int row, int col) const
 {
-    if(row >= 0 && row < m_cells.size() &&
-        col >= 0 && col < m_cells[row].size())
+    const int localRow = row - m_firstRow;
+    if(localRow >= 0 && localRow < m_cells.size() &&
+        col >= 0 && col < m_cells[localRow].size())
     {
-        return m_cells[row][col];
+        return m_cells[localRow][col];
     }
     return nullptr;
 }
 
+// Clamped to the last full window
+void GridViewManager::scrollToRow(int row)
+{
+    m_scrollBar->setValue(row);
+}
+
+void GridViewManager::wheelEvent(QWheelEvent* event)
+{
+    if(!m_scrollBar->isVisible())
+    {
+        QWidget::wheelEvent(event);
+        return;
+    }
+
+    const int steps = event->angleDelta().y() / 120;
+    m_scrollBar->setValue(m_scrollBar->value() - steps);
+    event->accept();
+}
+
+void GridViewManager::contextMenuEvent(QContextMenuEvent* event)
+{
+    for(QWidget* child = childAt(event->pos()); child && child != this; child = child->parentWidget())
+    {
+        if(GridCellWidget* cell = qobject_cast<GridCellWidget*>(child))
+        {
+            emit cellContextMenuRequested(cell->getGridIndex(), event->globalPos());
+            event->accept();
+            return;
+        }
+    }
+    QWidget::contextMenuEvent(event);
+}
+
+// Re-labels the existing widgets with their new grid rows; the owner
+// rebinds them to the models of those rows on visibleRowsChanged
+void GridViewManager::handleScroll(int firstRow)
+{
+    m_firstRow = firstRow;
+    for(int row = 0; row < m_cells.size(); ++row)
+    {
+        for(int col = 0; col < m_cells[row].size(); ++col)
+        {
+            m_cells[row][col]->setGridIndex(QPoint(m_firstRow + row, col));
+        }
+    }
+    emit visibleRowsChanged(m_firstRow, m_cells.size());
+}
+
 // void GridViewManager::dragEnterEvent(QDragEnterEvent* event)
 // {
 //     if(event->mimeData()->hasText())
@@ -190,17 +276,27 @@ void GridViewManager::handleSwapRequested(QPoint source, QPoint target)
 
 void GridViewManager::clearGrid()
 {
+    clearHighlight();
     for(auto& row : m_cells)
     {
         for(auto cell : row)
         {
-            m_gridLayout->removeWidget(cell);
-            cell->deleteLater();
+            releaseCell(cell);
         }
     }
     m_cells.clear();
 }
 
+void GridViewManager::releaseCell(GridCellWidget* cell)
+{
+    if(!cell)
+        return;
+    if(cell == m_highlightedCell)
+        clearHighlight();
+    m_gridLayout->removeWidget(cell);
+    m_widgetPool.release(cell);
+}
+
 void GridViewManager::highlightCell(int row, int col)
 {
     clearHighlight();
@@ -225,7 +321,7 @@ void GridViewManager::clearHighlight()
 
 QPoint GridViewManager::getCellIndexFromPos(const QPoint& indx)
 {
-    if(indx.x() >= 0 && indx.x() < gridRows() &&
+    if(indx.x() >= m_firstRow && indx.x() < m_firstRow + visibleRowCount() &&
         indx.y() >= 0 && indx.y() < gridCols())
     {
         return indx;
@@ -233,51 +329,10 @@ QPoint GridViewManager::getCellIndexFromPos(const QPoint& indx)
     return QPoint(-1, -1);
 }
 
-void GridViewManager::updateCellContent(int row, int col, NetworkInfoModel* model)
-{
-    GridCellWidget* current = cellAt(row, col);
-
-    // Handle existing NetworkInfoViewWidget updates
-    if (current && qobject_cast<NetworkInfoViewWidget*>(current))
-    {
-        NetworkInfoViewWidget* viewWidget = static_cast<NetworkInfoViewWidget*>(current);
-
-        // Only update if model changed
-        if (viewWidget->getMac() != model->getMac())
-        {
-            viewWidget->setUpdatesEnabled(false);
-
-            // Disconnect old model signals
-            disconnect(viewWidget->getModel(), &NetworkInfoModel::propertyChanged,
-                       viewWidget, &NetworkInfoViewWidget::updateProperty);
-
-            // Connect to new model
-            viewWidget->setViewModel(model);
-            connect(model, &NetworkInfoModel::propertyChanged,
-                    viewWidget, &NetworkInfoViewWidget::updateProperty,
-                    Qt::QueuedConnection);
-
-            viewWidget->setUpdatesEnabled(true);
-        }
-    }
-    else
-    {
-        setCell(row, col, createCellWidgetForModel(model));
-    }
-}
-
 GridCellWidget* GridViewManager::createCellWidgetForModel(NetworkInfoModel* model)
 {
     if (!model)
-        return new PlaceHolderCellWidget(this);
-
-    NetworkInfoViewWidget* widget = new NetworkInfoViewWidget(model);
-    widget->setUpdatesEnabled(false);
-
-    connect(model, &NetworkInfoModel::propertyChanged,
-            widget, &NetworkInfoViewWidget::updateProperty,
-            Qt::QueuedConnection);
+        return m_widgetPool.acquirePlaceholder();
 
-    widget->setUpdatesEnabled(true);
-    return widget;
+    return m_widgetPool.acquireInfoWidget(model);
 }
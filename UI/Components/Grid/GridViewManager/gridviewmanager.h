@@ -5,9 +5,15 @@
 #include <QGridLayout>
 #include <QVector>
 
+#include "cellwidgetpool.h"
+
+class QScrollBar;
 class GridCellWidget;
 class NetworkInfoModel;
 
+// Widgets only exist for the visibleRows rows currently scrolled into
+// view; row arguments are grid rows and cells outside the window are
+// ignored.
 class GridViewManager : public QWidget
 {
     Q_OBJECT
@@ -15,17 +21,26 @@ public:
     explicit GridViewManager(QWidget *parent = nullptr);
     ~GridViewManager();
 
-    void setGridSize(int rows, int cols);
+    void setGridSize(int rows, int cols, int visibleRows);
     GridCellWidget* cellAt(int row, int col) const;
     void setCell(int row, int col, GridCellWidget* widget);
     void updateCell(int row, int col, NetworkInfoModel* model);
     void clearCell(int row, int col);
 
-    int gridRows() const { return m_cells.size(); }
+    int gridRows() const { return m_totalRows; }
     int gridCols() const { return m_cells.isEmpty() ? 0 : m_cells[0].size(); }
+    int firstVisibleRow() const { return m_firstRow; }
+    int visibleRowCount() const { return m_cells.size(); }
+    void scrollToRow(int row);
 
 signals:
     void cellSwapRequestToDataManager(QPoint from, QPoint to);
+    void visibleRowsChanged(int firstRow, int rowCount);
+    void cellContextMenuRequested(QPoint indx, QPoint globalPos);
+
+protected:
+    void wheelEvent(QWheelEvent* event) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
 
 // protected:
 //     void dragEnterEvent(QDragEnterEvent* event) override;
@@ -35,17 +50,23 @@ signals:
 
 private slots:
     void handleSwapRequested(QPoint source, QPoint target);
+    void handleScroll(int firstRow);
 
 private:
     void clearGrid();
+    void releaseCell(GridCellWidget* cell);
     void highlightCell(int row, int col);
     void clearHighlight();
     QPoint getCellIndexFromPos(const QPoint& indx);
-    void updateCellContent(int row, int col, NetworkInfoModel* model);
     GridCellWidget* createCellWidgetForModel(NetworkInfoModel* model);
 
+    QWidget* m_gridContainer;
     QGridLayout* m_gridLayout;
-    QVector<QVector<GridCellWidget*>> m_cells;
+    QScrollBar* m_scrollBar;
+    CellWidgetPool m_widgetPool;
+    QVector<QVector<GridCellWidget*>> m_cells;// visible window, local rows
+    int m_totalRows = 0;
+    int m_firstRow = 0;
     GridCellWidget* m_highlightedCell = nullptr;
 };
 
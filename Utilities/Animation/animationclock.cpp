@@ -0,0 +1,94 @@
+#include "animationclock.h"
+
+AnimationClock::AnimationClock(QObject* parent)
+    : QObject{parent}
+{
+    m_timer.setInterval(DEFAULT_INTERVAL_MS);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, [this]()
+            {
+                emit tick(m_elapsed.elapsed());
+            });
+    m_elapsed.start();
+}
+
+AnimationClock& AnimationClock::instance()
+{
+    static AnimationClock instance;
+    return instance;
+}
+
+void AnimationClock::subscribe(QObject* subscriber)
+{
+    if(!subscriber || m_subscribers.contains(subscriber))
+        return;
+
+    m_subscribers.insert(subscriber,
+                         connect(subscriber, &QObject::destroyed, this, [this](QObject* object)
+                                 {
+                                     unsubscribe(object);
+                                 }));
+
+    if(!m_timer.isActive() && !m_paused)
+    {
+        m_timer.start();
+    }
+}
+
+void AnimationClock::unsubscribe(QObject* subscriber)
+{
+    auto it = m_subscribers.find(subscriber);
+    if(it == m_subscribers.end())
+        return;
+
+    disconnect(it.value());
+    m_subscribers.erase(it);
+    if(m_subscribers.isEmpty())
+    {
+        m_timer.stop();
+    }
+}
+
+bool AnimationClock::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+void AnimationClock::setPaused(bool paused)
+{
+    if(m_paused == paused)
+        return;
+
+    m_paused = paused;
+    if(m_paused)
+    {
+        m_timer.stop();
+    }
+    else if(!m_subscribers.isEmpty())
+    {
+        m_timer.start();
+        emit tick(m_elapsed.elapsed());
+    }
+}
+
+bool AnimationClock::isPaused() const
+{
+    return m_paused;
+}
+
+void AnimationClock::setInterval(int intervalMs)
+{
+    m_timer.setInterval(qMax(1, intervalMs));
+}
+
+qint64 AnimationClock::elapsed() const
+{
+    return m_elapsed.elapsed();
+}
+
+qreal AnimationClock::phase(int periodMs) const
+{
+    if(periodMs <= 0)
+        return 0.0;
+    return (m_elapsed.elapsed() % periodMs) / qreal(periodMs);
+}
@@ -0,0 +1,45 @@
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+
+// Application-wide frame clock for small UI animations. The timer only
+// runs while at least one subscriber is registered, and every subscriber
+// sees the same phase so all animated items pulse in sync. While paused
+// (window hidden) the timer stays off regardless of subscribers.
+class AnimationClock : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int DEFAULT_INTERVAL_MS = 33;
+
+    static AnimationClock& instance();
+
+    void subscribe(QObject* subscriber);
+    void unsubscribe(QObject* subscriber);
+    bool isRunning() const;
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    void setInterval(int intervalMs);
+    // Milliseconds on the same time base as tick()
+    qint64 elapsed() const;
+    // Position within a cycle of periodMs, in [0, 1)
+    qreal phase(int periodMs) const;
+
+signals:
+    void tick(qint64 elapsedMs);
+
+private:
+    explicit AnimationClock(QObject* parent = nullptr);
+
+    QTimer m_timer;
+    QElapsedTimer m_elapsed;
+    QHash<QObject*, QMetaObject::Connection> m_subscribers;
+    bool m_paused = false;
+};
+
+#endif // ANIMATIONCLOCK_H
@@ -1,22 +1,19 @@
 #include "ledindicatordelegate.h"
 #include "ledindicator.h"
+#include "../Animation/animationclock.h"
 
-#include <QTimer>
-#include <QTableView>
-#include <QDateTime>
+#include <QAbstractItemView>
 #include <QPainter>
+#include <QtMath>
+#include <utility>
 
 LedIndicatorDelegate::LedIndicatorDelegate(QObject* parent) : QStyledItemDelegate(parent)
 {
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [this]()
-            {
-                if (QTableView* view = qobject_cast<QTableView*>(this->parent()))
-                {
-                    view->viewport()->update();
-                }
-            });
-    timer->start(50);
+}
+
+LedIndicatorDelegate::~LedIndicatorDelegate()
+{
+    AnimationClock::instance().unsubscribe(this);
 }
 
 void LedIndicatorDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -38,18 +35,10 @@ void LedIndicatorDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
                 if (state == 1)// Yellow state
                 {
                     animateColor(color);
+                    trackAnimated(option, index);
                 }
 
                 drawLED(painter, option, color);
-
-                // Animation logic for yellow state
-                if (state == 1)
-                {
-                    qint64 ms = QDateTime::currentMSecsSinceEpoch();
-                    qreal progress = (ms % 1000) / 1000.0;
-                    qreal alpha = 0.5 + 0.5 * qSin(progress * 2 * M_PI);
-                    color.setAlphaF(alpha);
-                }
             }
         }
         else
@@ -70,6 +59,46 @@ QSize LedIndicatorDelegate::sizeHint(const QStyleOptionViewItem &option, const Q
     return QStyledItemDelegate::sizeHint(option, index);
 }
 
+// Each tick repaints only the LEDs that were animated in the previous
+// frame; painting re-registers the ones that are still yellow, so the
+// clock subscription ends by itself once nothing animates anymore.
+void LedIndicatorDelegate::handleAnimationTick()
+{
+    const QSet<QPersistentModelIndex> animated = std::exchange(m_animated, {});
+    if(animated.isEmpty() || !m_view)
+    {
+        disconnect(m_tickConnection);
+        m_tickConnection = {};
+        AnimationClock::instance().unsubscribe(this);
+        return;
+    }
+
+    for(const QPersistentModelIndex& index : animated)
+    {
+        if(index.isValid())
+        {
+            m_view->update(index);
+        }
+    }
+}
+
+void LedIndicatorDelegate::trackAnimated(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    if(!m_view)
+    {
+        m_view = qobject_cast<QAbstractItemView*>(const_cast<QWidget*>(option.widget));
+    }
+    m_animated.insert(index);
+
+    if(!m_tickConnection)
+    {
+        LedIndicatorDelegate* self = const_cast<LedIndicatorDelegate*>(this);
+        m_tickConnection = connect(&AnimationClock::instance(), &AnimationClock::tick,
+                                   self, &LedIndicatorDelegate::handleAnimationTick);
+        AnimationClock::instance().subscribe(self);
+    }
+}
+
 int LedIndicatorDelegate::determineStateFromValue(const QVariant &value) const
 {
     //TODO: mb later add yellow processing
@@ -92,8 +121,7 @@ QColor LedIndicatorDelegate::getColorForState(int state) const
 
 void LedIndicatorDelegate::animateColor(QColor &color) const
 {
-    qint64 ms = QDateTime::currentMSecsSinceEpoch();
-    qreal progress = (ms % 1000) / 1000.0;
+    qreal progress = AnimationClock::instance().phase(1000);
     qreal alpha = 0.5 + 0.5 * qSin(progress * 2 * M_PI);
     color.setAlphaF(alpha);
 }
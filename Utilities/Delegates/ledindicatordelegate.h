@@ -2,19 +2,32 @@
 #define LEDINDICATORDELEGATE_H
 
 #include <QStyledItemDelegate>
+#include <QPointer>
+#include <QSet>
+#include <QPersistentModelIndex>
+
+class QAbstractItemView;
 
 class LedIndicatorDelegate: public QStyledItemDelegate
 {
     Q_OBJECT
 public:
     explicit LedIndicatorDelegate(QObject* parent = nullptr);
+    ~LedIndicatorDelegate();
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 private:
+    void handleAnimationTick();
+    void trackAnimated(const QStyleOptionViewItem &option, const QModelIndex &index) const;
     int determineStateFromValue(const QVariant &value) const;
     QColor getColorForState(int state) const;
     void animateColor(QColor &color) const;
     void drawLED(QPainter *painter, const QStyleOptionViewItem &option, const QColor &color) const;
+
+    // LEDs painted in the animated (yellow) state since the last tick
+    mutable QSet<QPersistentModelIndex> m_animated;
+    mutable QPointer<QAbstractItemView> m_view;
+    mutable QMetaObject::Connection m_tickConnection;
 };
 
 #endif // LEDINDICATORDELEGATE_H
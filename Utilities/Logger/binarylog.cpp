@@ -0,0 +1,160 @@
+#include "binarylog.h"
+
+#include <QDateTime>
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace BinaryLog
+{
+QStringList decodeArgs(const char* payload, int size)
+{
+    QStringList args;
+    const char* pos = payload;
+    const char* end = payload + size;
+
+    while(pos < end)
+    {
+        const ArgType type = ArgType(quint8(*pos++));
+        switch(type)
+        {
+        case IntArg:
+        case UIntArg:
+        case DoubleArg:
+        {
+            if(end - pos < 8)
+                return args;
+            if(type == IntArg)
+            {
+                qint64 value;
+                std::memcpy(&value, pos, sizeof(value));
+                args << QString::number(value);
+            }
+            else if(type == UIntArg)
+            {
+                quint64 value;
+                std::memcpy(&value, pos, sizeof(value));
+                args << QString::number(value);
+            }
+            else
+            {
+                double value;
+                std::memcpy(&value, pos, sizeof(value));
+                args << QString::number(value);
+            }
+            pos += 8;
+            break;
+        }
+        case Utf16Arg:
+        case Utf8Arg:
+        {
+            quint16 length;
+            if(end - pos < qsizetype(sizeof(length)))
+                return args;
+            std::memcpy(&length, pos, sizeof(length));
+            pos += sizeof(length);
+
+            const qsizetype bytes = type == Utf16Arg ? length * qsizetype(sizeof(char16_t)) : length;
+            if(end - pos < bytes)
+                return args;
+            if(type == Utf16Arg)
+            {
+                QString text(length, Qt::Uninitialized);
+                std::memcpy(text.data(), pos, bytes);
+                args << text;
+            }
+            else
+            {
+                args << QString::fromUtf8(pos, length);
+            }
+            pos += bytes;
+            break;
+        }
+        default:
+            return args;
+        }
+    }
+    return args;
+}
+
+// One pass over the format, as the multi-argument QString::arg() does:
+// the lowest placeholder number takes the first argument, the next one the
+// second, and so on. Substituted text is never scanned again, so an
+// argument that contains "%1" is printed as is.
+QString formatMessage(const QString& format, const char* payload, int size)
+{
+    const QStringList args = decodeArgs(payload, size);
+
+    struct Placeholder
+    {
+        qsizetype pos;
+        qsizetype length;
+        int number;
+    };
+    QVarLengthArray<Placeholder, 16> placeholders;
+    for(qsizetype i = 0; i + 1 < format.size(); ++i)
+    {
+        if(format[i] != u'%' || !format[i + 1].isDigit())
+            continue;
+
+        int number = format[i + 1].digitValue();
+        qsizetype length = 2;
+        if(i + 2 < format.size() && format[i + 2].isDigit())
+        {
+            number = number * 10 + format[i + 2].digitValue();
+            ++length;
+        }
+        if(number > 0)
+        {
+            placeholders.append({i, length, number});
+            i += length - 1;
+        }
+    }
+
+    QVarLengthArray<int, 16> numbers;
+    for(const Placeholder& placeholder : placeholders)
+    {
+        if(!numbers.contains(placeholder.number))
+            numbers.append(placeholder.number);
+    }
+    std::sort(numbers.begin(), numbers.end());
+
+    QString message;
+    message.reserve(format.size());
+    qsizetype copied = 0;
+    for(const Placeholder& placeholder : placeholders)
+    {
+        const int argIndex = int(std::find(numbers.cbegin(), numbers.cend(), placeholder.number) - numbers.cbegin());
+        if(argIndex >= args.size())
+            continue;
+
+        message += QStringView(format).mid(copied, placeholder.pos - copied);
+        message += args[argIndex];
+        copied = placeholder.pos + placeholder.length;
+    }
+    message += QStringView(format).mid(copied);
+    return message;
+}
+
+QString levelName(int level)
+{
+    switch(level)
+    {
+    case 0:
+        return "DEBUG";
+    case 1:
+        return "INFO";
+    case 2:
+        return "WARN";
+    case 3:
+        return "CRIT";
+    }
+    return "?";
+}
+
+QString formatLine(qint64 epochMs, int level, QStringView category, QStringView message)
+{
+    return QString("[%1] %2 <%3> %4\n")
+        .arg(QDateTime::fromMSecsSinceEpoch(epochMs).toString(Qt::ISODate),
+             levelName(level), category, message);
+}
+}
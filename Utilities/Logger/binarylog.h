@@ -0,0 +1,133 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <cstring>
+#include <type_traits>
+
+// Shared between Logger and the ugnsm-logdump tool, so this header must
+// only depend on QtCore.
+//
+// A binary log file is a sequence of sessions. Each session starts with
+// the magic and a wall-clock/monotonic anchor pair, followed by entries
+// written with QDataStream:
+//   CategoryEntry  quint16 id, QByteArray name
+//   FormatEntry    quint16 id, QByteArray format
+//   RecordEntry    qint64 monotonicNs, quint8 kind, quint8 level,
+//                  quint16 categoryId, quint16 formatId, quint16 size, payload
+// Record payloads hold the raw arguments (tag byte + value, host byte
+// order) and are only turned into text by the reader.
+namespace BinaryLog
+{
+constexpr char Magic[8] = {'U', 'G', 'N', 'S', 'M', 'B', 'L', '1'};
+constexpr quint16 NoId = 0xFFFF;
+
+enum EntryType : quint8
+{
+    CategoryEntry = 1,
+    FormatEntry = 2,
+    RecordEntry = 3
+};
+
+enum RecordKind : quint8
+{
+    TextRecord = 0,      // payload: category and message as two string args
+    FormattedRecord = 1  // payload: arguments for a registered format string
+};
+
+enum ArgType : quint8
+{
+    IntArg = 1,
+    UIntArg,
+    DoubleArg,
+    Utf16Arg,
+    Utf8Arg
+};
+
+template<typename>
+constexpr bool UnsupportedArg = false;
+
+class ArgWriter
+{
+public:
+    ArgWriter(char* buffer, int capacity)
+        : m_begin(buffer), m_pos(buffer), m_end(buffer + capacity)
+    {
+    }
+
+    template<typename T>
+    void append(const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            putScalar(UIntArg, quint64(value));
+        else if constexpr (std::is_enum_v<T>)
+            putScalar(IntArg, qint64(value));
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            putScalar(IntArg, qint64(value));
+        else if constexpr (std::is_integral_v<T>)
+            putScalar(UIntArg, quint64(value));
+        else if constexpr (std::is_floating_point_v<T>)
+            putScalar(DoubleArg, double(value));
+        else if constexpr (std::is_convertible_v<const T&, QStringView>)
+            putUtf16(QStringView(value));
+        else if constexpr (std::is_convertible_v<const T&, const char*>)
+            putUtf8(static_cast<const char*>(value));
+        else
+            static_assert(UnsupportedArg<T>, "unsupported binary log argument type");
+    }
+
+    int size() const { return int(m_pos - m_begin); }
+
+private:
+    template<typename V>
+    void putScalar(ArgType type, V value)
+    {
+        if(m_end - m_pos < qsizetype(1 + sizeof(V)))
+            return;
+        *m_pos++ = char(type);
+        std::memcpy(m_pos, &value, sizeof(V));
+        m_pos += sizeof(V);
+    }
+
+    // Strings are truncated to whatever fits in the record.
+    void putUtf16(QStringView text)
+    {
+        const qsizetype room = (m_end - m_pos - 3) / qsizetype(sizeof(char16_t));
+        if(room < 0)
+            return;
+        const quint16 length = quint16(qMin<qsizetype>(qMin<qsizetype>(text.size(), room), 0xFFFF));
+        *m_pos++ = char(Utf16Arg);
+        std::memcpy(m_pos, &length, sizeof(length));
+        m_pos += sizeof(length);
+        std::memcpy(m_pos, text.utf16(), length * sizeof(char16_t));
+        m_pos += length * sizeof(char16_t);
+    }
+
+    void putUtf8(const char* text)
+    {
+        const qsizetype room = m_end - m_pos - 3;
+        if(room < 0)
+            return;
+        const qsizetype textSize = text ? qsizetype(std::strlen(text)) : 0;
+        const quint16 length = quint16(qMin<qsizetype>(qMin<qsizetype>(textSize, room), 0xFFFF));
+        *m_pos++ = char(Utf8Arg);
+        std::memcpy(m_pos, &length, sizeof(length));
+        m_pos += sizeof(length);
+        std::memcpy(m_pos, text, length);
+        m_pos += length;
+    }
+
+    char* m_begin;
+    char* m_pos;
+    char* m_end;
+};
+
+QStringList decodeArgs(const char* payload, int size);
+QString formatMessage(const QString& format, const char* payload, int size);
+QString levelName(int level);
+QString formatLine(qint64 epochMs, int level, QStringView category, QStringView message);
+}
+
+#endif // BINARYLOG_H
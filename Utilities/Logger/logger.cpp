@@ -1,21 +1,29 @@
 #include "logger.h"
 
 #include <QMutexLocker>
+#include <QDataStream>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <chrono>
+#include <cstring>
 
 Logger::Logger(QObject* parent)
-    : QObject{parent}
+    : QObject{parent},
+    m_textLog("app.log"),
+    m_binaryLog("app.blog"),
+    m_anchorEpochMs(QDateTime::currentMSecsSinceEpoch()),
+    m_anchorNs(monotonicNs())
 {
-    m_file.setFileName("app.log");
-    if(m_file.open(QIODevice::WriteOnly | QIODevice::Append))
-    {
-        m_stream.setDevice(&m_file);
-    }
+    m_textLog.open();
 }
 
 Logger::~Logger()
 {
-    m_file.close();
+    QMutexLocker lock(&m_mutex);
+    stopWriter();
+    m_textLog.close();
+    m_binaryLog.close();
+    qDeleteAll(m_categoryFilters);
 }
 
 Logger& Logger::instance()
@@ -26,34 +34,317 @@ Logger& Logger::instance()
 
 void Logger::log(LogLevel level, const QString& message, const QString& category)
 {
+    if(m_async.loadAcquire())
+    {
+        if(push([&](LogRecord& record) { fillTextRecord(record, level, message, category); }))
+            return;
+    }
+
+    LogRecord record;
+    fillTextRecord(record, level, message, category);
+    writeSynchronously(record);
+}
+
+quint16 Logger::registerCategory(const char* name)
+{
+    QMutexLocker lock(&m_registryMutex);
+    const QByteArray key(name);
+    qsizetype id = m_categories.indexOf(key);
+    if(id < 0)
     {
-        QMutexLocker lock(&m_mutex);
-        if(!m_file.isOpen()) return;
+        m_categories.append(key);
+        m_categoryFilters.append(new LogCategory(quint16(m_categories.size() - 1), UGNSM_LOG_MIN_LEVEL));
+        id = m_categories.size() - 1;
+    }
+    return quint16(id);
+}
+
+LogCategory& Logger::category(const char* name)
+{
+    const quint16 id = registerCategory(name);
+    QMutexLocker lock(&m_registryMutex);
+    return *m_categoryFilters[id];
+}
+
+void Logger::setCategoryLevel(const char* name, LogLevel level)
+{
+    category(name).setMinLevel(level);
+}
+
+quint16 Logger::registerFormat(const char* format)
+{
+    QMutexLocker lock(&m_registryMutex);
+    m_formats.append(QByteArray(format));
+    return quint16(m_formats.size() - 1);
+}
+
+void Logger::setMode(Mode mode)
+{
+    QMutexLocker lock(&m_mutex);
+    if(mode == Asynchronous && !m_writer)
+    {
+        startWriter();
+    }
+    else if(mode == Synchronous && m_writer)
+    {
+        stopWriter();
+    }
+}
+
+Logger::Mode Logger::mode() const
+{
+    return m_async.loadAcquire() ? Asynchronous : Synchronous;
+}
+
+void Logger::setOutputFormat(OutputFormat format)
+{
+    QMutexLocker lock(&m_mutex);
+    if((format == BinaryFormat) == bool(m_binaryOutput.loadAcquire()))
+        return;
 
-        QString levelStr;
-        switch(level)
+    // Restart the writer so a new binary session re-emits every definition
+    const bool restart = m_writer != nullptr;
+    stopWriter();
+
+    if(format == BinaryFormat)
+    {
+        if(m_binaryLog.open())
         {
-        case Debug:
-            levelStr = "DEBUG";
-            break;
-        case Info:
-            levelStr = "INFO";
-            break;
-        case Warning:
-            levelStr = "WARN";
-            break;
-        case Critical:
-            levelStr = "CRIT";
-            break;
+            writeBinaryHeader();
+            m_binaryOutput.storeRelease(1);
         }
+    }
+    else
+    {
+        m_binaryOutput.storeRelease(0);
+        m_binaryLog.close();
+    }
+
+    if(restart)
+    {
+        startWriter();
+    }
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy)
+{
+    m_overflowPolicy.storeRelaxed(policy);
+}
+
+void Logger::setSyncInterval(int intervalMs)
+{
+    m_syncIntervalMs.storeRelaxed(qMax(0, intervalMs));
+}
 
-        QString logLine = QString("[%1] %2 <%3> %4\n")
-                              .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
-                              .arg(levelStr)
-                              .arg(category)
-                              .arg(message);
+void Logger::setSegmentLimits(const LogSegmentFile::Limits& limits)
+{
+    m_textLog.setLimits(limits);
+    m_binaryLog.setLimits(limits);
+}
+
+quint64 Logger::droppedMessages() const
+{
+    return m_dropped.loadRelaxed();
+}
+
+qint64 Logger::monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Logger::fillTextRecord(LogRecord& record, LogLevel level,
+                            const QString& message, const QString& category) const
+{
+    record.timestampNs = monotonicNs();
+    record.kind = BinaryLog::TextRecord;
+    record.level = quint8(level);
+    record.categoryId = BinaryLog::NoId;
+    record.formatId = BinaryLog::NoId;
+    BinaryLog::ArgWriter writer(record.payload, LogRecord::PayloadCapacity);
+    writer.append(category);
+    writer.append(message);
+    record.payloadSize = quint16(writer.size());
+}
+
+void Logger::writeSynchronously(const LogRecord& record)
+{
+    const QByteArray line = recordToText(record).toUtf8();
+
+    QMutexLocker lock(&m_mutex);
+    if(!m_textLog.isOpen()) return;
+    if(m_async.loadAcquire())
+    {
+        // The writer was started while we waited for the lock
+        push([&](LogRecord& slot) { slot = record; });
+        return;
+    }
+
+    m_textLog.rotateIfNeeded(line.size());
+    m_textLog.write(line);
+    m_textLog.flush();
+}
+
+// Every binary segment is a self-contained session so archives can be
+// decoded on their own.
+void Logger::writeBinaryHeader()
+{
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.writeRawData(BinaryLog::Magic, sizeof(BinaryLog::Magic));
+    out << m_anchorEpochMs << m_anchorNs;
+    m_binaryLog.write(header);
+}
+
+QString Logger::recordToText(const LogRecord& record)
+{
+    const qint64 epochMs = m_anchorEpochMs + (record.timestampNs - m_anchorNs) / 1000000;
+
+    if(record.kind == BinaryLog::TextRecord)
+    {
+        const QStringList args = BinaryLog::decodeArgs(record.payload, record.payloadSize);
+        return BinaryLog::formatLine(epochMs, record.level,
+                                     args.value(0), args.value(1));
+    }
+
+    QString category;
+    QString format;
+    {
+        QMutexLocker lock(&m_registryMutex);
+        category = QString::fromUtf8(m_categories.value(record.categoryId));
+        format = QString::fromUtf8(m_formats.value(record.formatId));
+    }
+    return BinaryLog::formatLine(epochMs, record.level, category,
+                                 BinaryLog::formatMessage(format, record.payload, record.payloadSize));
+}
+
+void Logger::appendBinaryDefinitions(QDataStream& out, int& writtenCategories, int& writtenFormats)
+{
+    QMutexLocker lock(&m_registryMutex);
+    for(; writtenCategories < m_categories.size(); ++writtenCategories)
+    {
+        out << quint8(BinaryLog::CategoryEntry) << quint16(writtenCategories)
+            << m_categories[writtenCategories];
+    }
+    for(; writtenFormats < m_formats.size(); ++writtenFormats)
+    {
+        out << quint8(BinaryLog::FormatEntry) << quint16(writtenFormats)
+            << m_formats[writtenFormats];
+    }
+}
+
+void Logger::wakeWriter()
+{
+    if(m_writerIdle.testAndSetOrdered(1, 0))
+    {
+        m_wake.release();
+    }
+}
+
+// Segments are only preallocated while the writer owns them; in
+// Synchronous mode a rotation runs on whichever thread is logging.
+void Logger::startWriter()
+{
+    m_textLog.setPreallocate(true);
+    m_binaryLog.setPreallocate(true);
+    m_stopRequested.storeRelease(0);
+    m_writer = QThread::create([this] { writerLoop(); });
+    m_writer->setObjectName("LogWriter");
+    m_writer->start(QThread::LowPriority);
+    m_async.storeRelease(1);
+}
+
+void Logger::stopWriter()
+{
+    if(!m_writer)
+        return;
+
+    m_async.storeRelease(0);
+    m_stopRequested.storeRelease(1);
+    m_writerIdle.storeRelease(1);
+    wakeWriter();
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+    m_textLog.setPreallocate(false);
+    m_binaryLog.setPreallocate(false);
+}
+
+// Drains the ring into one buffer per pass and writes it with a single
+// call; the file is fsync'ed at most once per sync interval. In binary
+// output the records are copied verbatim and only new category/format
+// definitions are emitted ahead of them; a rotated segment starts a new
+// session and repeats all definitions.
+void Logger::writerLoop()
+{
+    const bool binary = m_binaryOutput.loadAcquire();
+    LogSegmentFile& file = binary ? m_binaryLog : m_textLog;
+
+    QByteArray records;
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    int writtenCategories = 0;
+    int writtenFormats = 0;
+
+    QElapsedTimer sinceSync;
+    sinceSync.start();
+    bool unsynced = false;
+
+    auto consume = [&](LogRecord& record)
+    {
+        if(binary)
+        {
+            recordStream << quint8(BinaryLog::RecordEntry) << record.timestampNs
+                         << record.kind << record.level << record.categoryId
+                         << record.formatId << record.payloadSize;
+            recordStream.writeRawData(record.payload, record.payloadSize);
+        }
+        else
+        {
+            records += recordToText(record).toUtf8();
+        }
+    };
+
+    for(;;)
+    {
+        const bool stopping = m_stopRequested.loadAcquire();
+        while(m_ring.tryPop(consume))
+        {
+        }
+
+        if(!records.isEmpty() && file.isOpen())
+        {
+            if(file.rotateIfNeeded(records.size()) && binary)
+            {
+                writtenCategories = 0;
+                writtenFormats = 0;
+                writeBinaryHeader();
+            }
+            if(binary)
+            {
+                QByteArray definitions;
+                QDataStream definitionStream(&definitions, QIODevice::WriteOnly);
+                appendBinaryDefinitions(definitionStream, writtenCategories, writtenFormats);
+                file.write(definitions);
+            }
+            file.write(records);
+            file.flush();
+            unsynced = true;
+        }
+        records.clear();
+        recordStream.device()->seek(0);
+
+        if(unsynced && (stopping || sinceSync.elapsed() >= m_syncIntervalMs.loadRelaxed()))
+        {
+            file.sync();
+            unsynced = false;
+            sinceSync.restart();
+        }
+
+        if(stopping)
+            break;
 
-        m_stream << logLine;
-        m_stream.flush();
+        m_writerIdle.storeRelease(1);
+        m_wake.tryAcquire(1, qMax(1, m_syncIntervalMs.loadRelaxed()));
+        m_writerIdle.storeRelease(0);
     }
 }
@@ -3,9 +3,61 @@
 
 #include <QObject>
 
-#include <QFile>
-#include <QTextStream>
 #include <QMutex>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QByteArrayList>
+#include <QThread>
+
+#include "mpscringbuffer.h"
+#include "binarylog.h"
+#include "logsegmentfile.h"
+
+class QDataStream;
+
+// Messages below UGNSM_LOG_MIN_LEVEL (a Logger::LogLevel value, set from
+// CMake) are compiled out together with their arguments. Everything else
+// is checked against the category's runtime level with one atomic load and
+// then queued with deferred formatting: the category and format string are
+// registered once per call site and only the raw arguments are recorded.
+// The format uses QString::arg placeholders (%1, %2, ...).
+#ifndef UGNSM_LOG_MIN_LEVEL
+#define UGNSM_LOG_MIN_LEVEL 0
+#endif
+
+#define UGNSM_LOG(level, categoryName, format, ...)                                               \
+    do                                                                                            \
+    {                                                                                             \
+        if constexpr (int(level) >= UGNSM_LOG_MIN_LEVEL)                                          \
+        {                                                                                         \
+            static LogCategory& ugnsmLogCategory = Logger::instance().category(categoryName);     \
+            if(ugnsmLogCategory.isEnabled(level))                                                 \
+            {                                                                                     \
+                static const quint16 ugnsmLogFormatId = Logger::instance().registerFormat(format); \
+                Logger::instance().logBinary(level, ugnsmLogCategory.id(), ugnsmLogFormatId       \
+                                             __VA_OPT__(,) __VA_ARGS__);                          \
+            }                                                                                     \
+        }                                                                                         \
+    } while(0)
+
+#define LOG_DEBUG(categoryName, format, ...) UGNSM_LOG(Logger::Debug, categoryName, format __VA_OPT__(,) __VA_ARGS__)
+#define LOG_INFO(categoryName, format, ...) UGNSM_LOG(Logger::Info, categoryName, format __VA_OPT__(,) __VA_ARGS__)
+#define LOG_WARNING(categoryName, format, ...) UGNSM_LOG(Logger::Warning, categoryName, format __VA_OPT__(,) __VA_ARGS__)
+#define LOG_CRITICAL(categoryName, format, ...) UGNSM_LOG(Logger::Critical, categoryName, format __VA_OPT__(,) __VA_ARGS__)
+
+class LogCategory
+{
+public:
+    LogCategory(quint16 id, int minLevel) : m_id(id), m_minLevel(minLevel) {}
+
+    quint16 id() const { return m_id; }
+    bool isEnabled(int level) const { return level >= m_minLevel.loadRelaxed(); }
+    void setMinLevel(int level) { m_minLevel.storeRelaxed(level); }
+
+private:
+    const quint16 m_id;
+    QAtomicInt m_minLevel;
+};
 
 class Logger : public QObject
 {
@@ -19,18 +71,140 @@ public:
         Critical
     };
 
+    enum Mode
+    {
+        Synchronous,    // format and write on the calling thread
+        Asynchronous    // enqueue a fixed-size record, a background writer formats it
+    };
+
+    enum OverflowPolicy
+    {
+        DropOnOverflow,     // count and discard records while the ring is full
+        BlockOnOverflow     // spin until the writer frees a slot
+    };
+
+    enum OutputFormat
+    {
+        TextFormat,     // app.log, one formatted line per record
+        BinaryFormat    // app.blog, raw records decoded offline by ugnsm-logdump
+    };
+
     static Logger& instance();
 
     void log(LogLevel level, const QString& message, const QString& category = "App");
 
+    template<typename... Args>
+    void logBinary(LogLevel level, quint16 categoryId, quint16 formatId, const Args&... args)
+    {
+        const qint64 timestamp = monotonicNs();
+        auto fill = [&](LogRecord& record)
+        {
+            record.timestampNs = timestamp;
+            record.kind = BinaryLog::FormattedRecord;
+            record.level = quint8(level);
+            record.categoryId = categoryId;
+            record.formatId = formatId;
+            BinaryLog::ArgWriter writer(record.payload, LogRecord::PayloadCapacity);
+            (writer.append(args), ...);
+            record.payloadSize = quint16(writer.size());
+        };
+
+        if(m_async.loadAcquire() && push(fill))
+            return;
+
+        LogRecord record;
+        fill(record);
+        writeSynchronously(record);
+    }
+
+    quint16 registerCategory(const char* name);
+    quint16 registerFormat(const char* format);
+    // Categories live as long as the Logger, call sites cache the reference.
+    LogCategory& category(const char* name);
+    void setCategoryLevel(const char* name, LogLevel level);
+
+    void setMode(Mode mode);
+    Mode mode() const;
+    // Binary output needs the background writer; in Synchronous mode
+    // records are still written as text to app.log.
+    void setOutputFormat(OutputFormat format);
+    void setOverflowPolicy(OverflowPolicy policy);
+    void setSyncInterval(int intervalMs);
+    // Applies to both app.log and app.blog.
+    void setSegmentLimits(const LogSegmentFile::Limits& limits);
+    quint64 droppedMessages() const;
+
 private:
+    struct LogRecord
+    {
+        static constexpr int PayloadCapacity = 360;
+
+        qint64 timestampNs;
+        quint8 kind;
+        quint8 level;
+        quint16 categoryId;
+        quint16 formatId;
+        quint16 payloadSize;
+        char payload[PayloadCapacity];
+    };
+
+    static constexpr int RingCapacity = 2048;
+
     explicit Logger(QObject* parent = nullptr);
     ~Logger();
 
+    static qint64 monotonicNs();
+
+    template<typename Fill>
+    bool push(Fill&& fill)
+    {
+        while(!m_ring.tryPush(fill))
+        {
+            if(m_overflowPolicy.loadRelaxed() == DropOnOverflow)
+            {
+                m_dropped.fetchAndAddRelaxed(1);
+                return true;
+            }
+            wakeWriter();
+            QThread::yieldCurrentThread();
+        }
+        wakeWriter();
+        return true;
+    }
 
-    QFile m_file;
-    QTextStream m_stream;
+    void fillTextRecord(LogRecord& record, LogLevel level,
+                        const QString& message, const QString& category) const;
+    void writeSynchronously(const LogRecord& record);
+    void writeBinaryHeader();
+    QString recordToText(const LogRecord& record);
+    void appendBinaryDefinitions(QDataStream& out, int& writtenCategories, int& writtenFormats);
+    void wakeWriter();
+    void startWriter();
+    void stopWriter();
+    void writerLoop();
+
+    LogSegmentFile m_textLog;
     QMutex m_mutex;
+
+    LogSegmentFile m_binaryLog;
+    QAtomicInt m_binaryOutput{0};
+    qint64 m_anchorEpochMs;
+    qint64 m_anchorNs;
+
+    QMutex m_registryMutex;
+    QByteArrayList m_categories;
+    QByteArrayList m_formats;
+    QList<LogCategory*> m_categoryFilters;
+
+    MpscRingBuffer<LogRecord, RingCapacity> m_ring;
+    QThread* m_writer = nullptr;
+    QSemaphore m_wake;
+    QAtomicInt m_async{0};
+    QAtomicInt m_writerIdle{0};
+    QAtomicInt m_stopRequested{0};
+    QAtomicInt m_overflowPolicy{DropOnOverflow};
+    QAtomicInt m_syncIntervalMs{1000};
+    QAtomicInteger<quint64> m_dropped{0};
 };
 
 #endif // LOGGER_H
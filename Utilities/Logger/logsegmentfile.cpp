@@ -0,0 +1,263 @@
+#include "logsegmentfile.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QMutex>
+#include <QHash>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#elif defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+QMutex s_capMutex;
+QHash<QString, qint64> s_reservations;// file name -> bytes reserved while open
+}
+
+LogSegmentFile::LogSegmentFile(const QString& fileName)
+{
+    m_file.setFileName(fileName);
+    setLimits(Limits());
+    setReservation(0);
+}
+
+LogSegmentFile::~LogSegmentFile()
+{
+    close();
+    QMutexLocker lock(&s_capMutex);
+    s_reservations.remove(m_file.fileName());
+}
+
+bool LogSegmentFile::open()
+{
+    if(m_file.isOpen())
+        return true;
+
+    // A previous run that did not shut down cleanly leaves the preallocated
+    // tail in place; readers stop at the zero padding.
+    if(QFileInfo(m_file.fileName()).size() > 0)
+    {
+        archiveSegment();
+    }
+    return openSegment();
+}
+
+void LogSegmentFile::close()
+{
+    if(!m_file.isOpen())
+        return;
+
+    m_file.flush();
+    m_file.resize(m_written);
+    m_file.close();
+    setReservation(0);
+}
+
+bool LogSegmentFile::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+bool LogSegmentFile::rotateIfNeeded(qint64 incomingBytes)
+{
+    if(!m_file.isOpen() || m_written == 0)
+        return false;
+
+    if(m_written + incomingBytes <= m_segmentSize.loadRelaxed() &&
+        m_age.elapsed() < m_maxAgeMs.loadRelaxed())
+    {
+        return false;
+    }
+
+    close();
+    archiveSegment();
+    openSegment();
+    return m_file.isOpen();
+}
+
+void LogSegmentFile::write(const QByteArray& data)
+{
+    if(!m_file.isOpen())
+        return;
+
+    m_written += m_file.write(data);
+}
+
+void LogSegmentFile::flush()
+{
+    if(m_file.isOpen())
+    {
+        m_file.flush();
+    }
+}
+
+void LogSegmentFile::sync()
+{
+    if(!m_file.isOpen())
+        return;
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#elif defined(Q_OS_UNIX)
+    ::fsync(m_file.handle());
+#endif
+}
+
+void LogSegmentFile::setLimits(const Limits& limits)
+{
+    m_segmentSize.storeRelaxed(qMax<qint64>(4096, limits.segmentSize));
+    m_maxAgeMs.storeRelaxed(qMax<qint64>(1000, limits.maxAgeMs));
+    m_maxTotalSize.storeRelaxed(qMax<qint64>(0, limits.maxTotalSize));
+}
+
+void LogSegmentFile::setPreallocate(bool preallocate)
+{
+    m_preallocate.storeRelaxed(preallocate);
+}
+
+LogSegmentFile::Limits LogSegmentFile::limits() const
+{
+    Limits limits;
+    limits.segmentSize = m_segmentSize.loadRelaxed();
+    limits.maxAgeMs = m_maxAgeMs.loadRelaxed();
+    limits.maxTotalSize = m_maxTotalSize.loadRelaxed();
+    return limits;
+}
+
+QThreadPool* LogSegmentFile::compressionPool()
+{
+    static QThreadPool pool;
+    static const bool configured = []
+    {
+        pool.setMaxThreadCount(1);
+        pool.setThreadPriority(QThread::LowestPriority);
+        return true;
+    }();
+    Q_UNUSED(configured)
+    return &pool;
+}
+
+bool LogSegmentFile::openSegment()
+{
+    if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    // Reserve the whole segment up front so appends do not keep extending
+    // the file and its metadata. Not on a caller's thread: allocating
+    // megabytes there would stall it.
+    const qint64 segmentSize = m_segmentSize.loadRelaxed();
+    if(m_preallocate.loadRelaxed())
+    {
+#if defined(Q_OS_LINUX)
+        if(::posix_fallocate(m_file.handle(), 0, segmentSize) != 0)
+        {
+            m_file.resize(segmentSize);
+        }
+#else
+        m_file.resize(segmentSize);
+#endif
+        m_file.seek(0);
+    }
+    setReservation(segmentSize);
+    m_written = 0;
+    m_age.start();
+    return true;
+}
+
+void LogSegmentFile::archiveSegment()
+{
+    const QFileInfo info(m_file.fileName());
+    const QString stem = info.dir().filePath(info.completeBaseName() + "-" +
+                                             QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz"));
+    QString archivePath = stem + "." + info.suffix();
+    for(int i = 1; QFile::exists(archivePath) || QFile::exists(archivePath + ".z"); ++i)
+    {
+        archivePath = QString("%1-%2.%3").arg(stem).arg(i).arg(info.suffix());
+    }
+
+    if(!QFile::rename(info.filePath(), archivePath))
+        return;
+
+    const qint64 maxTotalSize = m_maxTotalSize.loadRelaxed();
+    compressionPool()->start([archivePath, maxTotalSize]
+    {
+        compressArchive(archivePath);
+        enforceDiskCap(maxTotalSize);
+    });
+}
+
+void LogSegmentFile::compressArchive(const QString& archivePath)
+{
+    QFile source(archivePath);
+    if(!source.open(QIODevice::ReadOnly))
+        return;
+    const QByteArray compressed = qCompress(source.readAll());
+    source.close();
+
+    QFile target(archivePath + ".z");
+    if(!target.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return;
+    if(target.write(compressed) == compressed.size())
+    {
+        target.close();
+        QFile::remove(archivePath);
+    }
+    else
+    {
+        target.remove();
+    }
+}
+
+void LogSegmentFile::setReservation(qint64 bytes)
+{
+    QMutexLocker lock(&s_capMutex);
+    s_reservations.insert(m_file.fileName(), bytes);
+}
+
+// Archives are named <base>-<timestamp>.<suffix>[.z]. Those of every segment
+// file are removed oldest first until they fit next to the open segments.
+void LogSegmentFile::enforceDiskCap(qint64 maxTotalSize)
+{
+    if(maxTotalSize <= 0)
+        return;
+
+    QHash<QString, qint64> reservations;
+    {
+        QMutexLocker lock(&s_capMutex);
+        reservations = s_reservations;
+    }
+
+    qint64 total = 0;
+    QFileInfoList archives;
+    for(auto it = reservations.cbegin(); it != reservations.cend(); ++it)
+    {
+        total += it.value();
+        const QFileInfo info(it.key());
+        archives += info.dir().entryInfoList(
+            {info.completeBaseName() + "-*." + info.suffix() + "*"}, QDir::Files);
+    }
+    std::sort(archives.begin(), archives.end(), [](const QFileInfo& a, const QFileInfo& b)
+              {
+                  return a.lastModified() < b.lastModified();
+              });
+    for(const QFileInfo& archive : std::as_const(archives))
+    {
+        total += archive.size();
+    }
+
+    for(const QFileInfo& archive : archives)
+    {
+        if(total <= maxTotalSize)
+            break;
+        if(QFile::remove(archive.filePath()))
+        {
+            total -= archive.size();
+        }
+    }
+}
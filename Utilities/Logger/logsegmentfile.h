@@ -0,0 +1,71 @@
+#ifndef LOGSEGMENTFILE_H
+#define LOGSEGMENTFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+
+class QThreadPool;
+
+// Active log segment plus its archives. The active file (e.g. app.log) is
+// written sequentially, preallocated to the segment size when a background
+// thread owns it; once it is full or too old it is trimmed, renamed to
+// app-<timestamp>.log and handed to a low-priority thread that compresses
+// it (qCompress, ".z" suffix) and deletes the oldest archives above the
+// disk cap. The cap is shared by every LogSegmentFile in the process: the
+// archives of all of them count against it, and every open segment
+// reserves its full size.
+//
+// Only one thread may write at a time; Logger serializes this between its
+// callers and the background writer.
+class LogSegmentFile
+{
+public:
+    struct Limits
+    {
+        qint64 segmentSize = 4 * 1024 * 1024;
+        qint64 maxAgeMs = 24 * 60 * 60 * 1000;
+        qint64 maxTotalSize = 64 * 1024 * 1024;
+    };
+
+    explicit LogSegmentFile(const QString& fileName);
+    ~LogSegmentFile();
+
+    // Archives whatever a previous run left behind and starts a new segment.
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // Starts a new segment if writing incomingBytes would overflow the
+    // current one or it is older than maxAgeMs. Returns true on rotation.
+    bool rotateIfNeeded(qint64 incomingBytes);
+    void write(const QByteArray& data);
+    void flush();
+    void sync();
+
+    void setLimits(const Limits& limits);
+    Limits limits() const;
+    // Only worth it off the caller's thread; applies from the next segment
+    void setPreallocate(bool preallocate);
+
+    static QThreadPool* compressionPool();
+
+private:
+    bool openSegment();
+    void archiveSegment();
+    static void compressArchive(const QString& archivePath);
+    void setReservation(qint64 bytes);
+    static void enforceDiskCap(qint64 maxTotalSize);
+
+    QFile m_file;
+    qint64 m_written = 0;
+    QElapsedTimer m_age;
+
+    QAtomicInteger<qint64> m_segmentSize;
+    QAtomicInteger<qint64> m_maxAgeMs;
+    QAtomicInteger<qint64> m_maxTotalSize;
+    QAtomicInt m_preallocate{0};
+};
+
+#endif // LOGSEGMENTFILE_H
@@ -0,0 +1,83 @@
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <QAtomicInteger>
+#include <QtGlobal>
+#include <array>
+
+// Bounded lock-free queue for many producers and a single consumer
+// (Vyukov's sequence-numbered ring). Records are filled and consumed in
+// place, so nothing is allocated or copied twice on the producer side.
+template<typename T, int Capacity>
+class MpscRingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    MpscRingBuffer()
+    {
+        for(int i = 0; i < Capacity; ++i)
+        {
+            m_cells[i].sequence.storeRelaxed(quint64(i));
+        }
+    }
+
+    // Producer side: returns false without blocking when the ring is full.
+    template<typename Fill>
+    bool tryPush(Fill&& fill)
+    {
+        quint64 pos = m_enqueuePos.loadRelaxed();
+        for(;;)
+        {
+            Cell& cell = m_cells[pos & Mask];
+            const qint64 diff = qint64(cell.sequence.loadAcquire()) - qint64(pos);
+            if(diff == 0)
+            {
+                if(m_enqueuePos.testAndSetRelaxed(pos, pos + 1, pos))
+                {
+                    fill(cell.data);
+                    cell.sequence.storeRelease(pos + 1);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.loadRelaxed();
+            }
+        }
+    }
+
+    // Consumer side: must only be called from the single consumer thread.
+    template<typename Consume>
+    bool tryPop(Consume&& consume)
+    {
+        Cell& cell = m_cells[m_dequeuePos & Mask];
+        if(qint64(cell.sequence.loadAcquire()) - qint64(m_dequeuePos + 1) < 0)
+            return false;
+
+        consume(cell.data);
+        cell.sequence.storeRelease(m_dequeuePos + Capacity);
+        ++m_dequeuePos;
+        return true;
+    }
+
+private:
+    static constexpr quint64 Mask = Capacity - 1;
+
+    struct Cell
+    {
+        QAtomicInteger<quint64> sequence;
+        T data;
+    };
+
+    alignas(64) QAtomicInteger<quint64> m_enqueuePos{0};
+    alignas(64) quint64 m_dequeuePos = 0;
+    std::array<Cell, Capacity> m_cells;
+};
+
+#endif // MPSCRINGBUFFER_H
@@ -0,0 +1,197 @@
+#include "sparklinewidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QtMath>
+#include <cmath>
+
+namespace
+{
+const QColor RX_COLOR(80, 160, 255);
+const QColor TX_COLOR(255, 150, 60);
+}
+
+SparklineWidget::SparklineWidget(QWidget* parent)
+    : QWidget(parent),
+    m_ring(MAX_SAMPLES)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setFixedHeight(28);
+}
+
+void SparklineWidget::setSamples(const QVector<Sample>& samples)
+{
+    m_count = 0;
+    m_scale = MIN_SCALE;
+    for(const Sample& sample : samples)
+    {
+        m_ring[m_count++ % MAX_SAMPLES] = sample;
+    }
+    fitScale(visibleMax());
+    m_sinceRescaleCheck = 0;
+    renderAll();
+    update();
+}
+
+void SparklineWidget::appendSample(const Sample& sample)
+{
+    m_ring[m_count++ % MAX_SAMPLES] = sample;
+
+    // Grow the scale at once; shrink it at most once per visible window
+    // so a full redraw stays amortized over many samples
+    bool rescaled = fitScale(qMax(sample.rx, sample.tx));
+    if(!rescaled && ++m_sinceRescaleCheck >= visibleSamples())
+    {
+        m_sinceRescaleCheck = 0;
+        const qreal peak = visibleMax();
+        if(peak * 4 < m_scale && m_scale > MIN_SCALE)
+        {
+            m_scale = MIN_SCALE;
+            fitScale(peak);
+            rescaled = true;
+        }
+    }
+
+    if(rescaled)
+    {
+        renderAll();
+    }
+    else
+    {
+        renderSegment(m_count - 1);
+    }
+    update();
+}
+
+void SparklineWidget::clear()
+{
+    setSamples({});
+}
+
+QSize SparklineWidget::sizeHint() const
+{
+    return QSize(MAX_SAMPLES, 28);
+}
+
+void SparklineWidget::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event)
+    if(m_image.isNull())
+        return;
+
+    // The ring origin is the column of the oldest visible sample: draw it
+    // and everything right of it first, then the wrapped part
+    QPainter painter(this);
+    const qreal dpr = m_image.devicePixelRatio();
+    const int width = visibleSamples() * STEP;
+    const int origin = columnOf(m_count);
+    const int left = this->width() - width;
+    const int h = height();
+
+    painter.drawImage(QRectF(left, 0, width - origin, h), m_image,
+                      QRectF(origin * dpr, 0, (width - origin) * dpr, h * dpr));
+    if(origin > 0)
+    {
+        painter.drawImage(QRectF(left + width - origin, 0, origin, h), m_image,
+                          QRectF(0, 0, origin * dpr, h * dpr));
+    }
+}
+
+void SparklineWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    renderAll();
+}
+
+int SparklineWidget::visibleSamples() const
+{
+    return qBound(1, width() / STEP, MAX_SAMPLES);
+}
+
+const SparklineWidget::Sample& SparklineWidget::sampleAt(quint64 sequence) const
+{
+    return m_ring[sequence % MAX_SAMPLES];
+}
+
+void SparklineWidget::renderAll()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize size(visibleSamples() * STEP, height());
+    if(m_image.size() != size * dpr || !qFuzzyCompare(m_image.devicePixelRatio(), dpr))
+    {
+        m_image = QImage(size * dpr, QImage::Format_ARGB32_Premultiplied);
+        m_image.setDevicePixelRatio(dpr);
+    }
+    m_image.fill(Qt::transparent);
+
+    const quint64 visible = quint64(visibleSamples());
+    const quint64 first = m_count > visible ? m_count - visible : 1;
+    for(quint64 sequence = qMax<quint64>(first, 1); sequence < m_count; ++sequence)
+    {
+        renderSegment(sequence);
+    }
+}
+
+// Draws the line from the previous sample to this one into the strip of
+// columns owned by this sample, overwriting whatever wrapped out of view
+void SparklineWidget::renderSegment(quint64 sequence)
+{
+    if(m_image.isNull())
+        return;
+
+    const QRect strip(columnOf(sequence), 0, STEP, height());
+    QPainter painter(&m_image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(strip, Qt::transparent);
+    if(sequence == 0)
+        return;
+
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(strip);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const Sample& previous = sampleAt(sequence - 1);
+    const Sample& current = sampleAt(sequence);
+    const qreal x0 = strip.left();
+    const qreal x1 = strip.left() + STEP;
+
+    painter.setPen(QPen(TX_COLOR, 1.2));
+    painter.drawLine(QPointF(x0, valueToY(previous.tx)), QPointF(x1, valueToY(current.tx)));
+    painter.setPen(QPen(RX_COLOR, 1.2));
+    painter.drawLine(QPointF(x0, valueToY(previous.rx)), QPointF(x1, valueToY(current.rx)));
+}
+
+// Raises the scale to the next power of two above value; returns true if
+// it changed
+bool SparklineWidget::fitScale(qreal value)
+{
+    if(value <= m_scale)
+        return false;
+
+    m_scale = qMax(MIN_SCALE, qreal(qNextPowerOfTwo(quint64(std::ceil(value)))));
+    return true;
+}
+
+qreal SparklineWidget::visibleMax() const
+{
+    const quint64 visible = quint64(visibleSamples());
+    const quint64 first = m_count > visible ? m_count - visible : 0;
+    qreal peak = 0;
+    for(quint64 sequence = first; sequence < m_count; ++sequence)
+    {
+        const Sample& sample = sampleAt(sequence);
+        peak = qMax(peak, qMax(sample.rx, sample.tx));
+    }
+    return peak;
+}
+
+int SparklineWidget::columnOf(quint64 sequence) const
+{
+    return int(sequence % quint64(visibleSamples())) * STEP;
+}
+
+qreal SparklineWidget::valueToY(qreal value) const
+{
+    const qreal h = height() - 2;
+    return 1 + h - qBound<qreal>(0, value / m_scale, 1) * h;
+}
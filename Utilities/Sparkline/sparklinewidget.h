@@ -0,0 +1,56 @@
+#ifndef SPARKLINEWIDGET_H
+#define SPARKLINEWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+
+// Two-series (rx/tx) throughput sparkline. The plot lives in a cached
+// QImage used as a ring of STEP-pixel columns: a new sample only draws its
+// own segment into the oldest column and moves the ring origin, so the
+// per-sample cost is constant. The image is redrawn in full only on
+// resize, reset or a change of vertical scale.
+class SparklineWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    struct Sample
+    {
+        qreal rx = 0;
+        qreal tx = 0;
+    };
+
+    explicit SparklineWidget(QWidget* parent = nullptr);
+
+    void setSamples(const QVector<Sample>& samples);
+    void appendSample(const Sample& sample);
+    void clear();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    int visibleSamples() const;
+    const Sample& sampleAt(quint64 sequence) const;
+    void renderAll();
+    void renderSegment(quint64 sequence);
+    bool fitScale(qreal value);
+    qreal visibleMax() const;
+    int columnOf(quint64 sequence) const;
+    qreal valueToY(qreal value) const;
+
+    QVector<Sample> m_ring;
+    quint64 m_count = 0;// samples appended since the last reset
+    qreal m_scale = MIN_SCALE;
+    int m_sinceRescaleCheck = 0;
+    QImage m_image;
+
+    static constexpr int MAX_SAMPLES = 180;
+    static constexpr int STEP = 2;
+    static constexpr qreal MIN_SCALE = 1024;// 1 KB/s full height
+};
+
+#endif // SPARKLINEWIDGET_H
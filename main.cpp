@@ -24,6 +24,7 @@ int main(int argc, char *argv[])
     qRegisterMetaType<QList<NetworkInfo*>>("QList<NetworkInfo*>");
 
     QApplication a(argc, argv);
+    Logger::instance().setMode(Logger::Asynchronous);
 
 
     QFile styleFile(QStringLiteral("://styles.qss"));
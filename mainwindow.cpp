@@ -1,11 +1,15 @@
 #include "mainwindow.h"
 #include "UI/Components/Grid/GridViewManager/gridviewmanager.h"
 #include "Core/Grid/Managment/gridmanager.h"
+#include "UI/Components/Debug/SchedulerMetricsPanel/schedulermetricspanel.h"
 
 
 #include <QResizeEvent>
 #include <QStatusBar>
 #include <QMessageBox>
+#include <QDockWidget>
+#include <QAction>
+#include <QWindow>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -31,6 +35,9 @@ void MainWindow::setupUI()
 
     setCentralWidget(m_gridManager->getView());
     statusBar()->showMessage("Ready", 3000);
+    setupDebugPanel();
+    setupRenderModeToggle();
+    setupLayoutActions();
 
     // Initial window setup
     const QSize initialSize(1280, 720);
@@ -38,6 +45,76 @@ void MainWindow::setupUI()
     setMinimumSize(800, 600);
 }
 
+void MainWindow::setupDebugPanel()
+{
+    QDockWidget* dock = new QDockWidget("Scheduler Metrics", this);
+    dock->setObjectName("schedulerMetricsDock");
+    dock->setWidget(new SchedulerMetricsPanel(m_gridManager->getScheduler(), dock));
+    addDockWidget(Qt::BottomDockWidgetArea, dock);
+    dock->hide();
+
+    QAction* toggleAction = dock->toggleViewAction();
+    toggleAction->setShortcut(Qt::Key_F12);
+    addAction(toggleAction);
+}
+
+void MainWindow::setupRenderModeToggle()
+{
+    QAction* canvasAction = new QAction("Canvas Rendering", this);
+    canvasAction->setCheckable(true);
+    canvasAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_R));
+    QAction* heatmapAction = new QAction("Heatmap Overview", this);
+    heatmapAction->setCheckable(true);
+    heatmapAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_H));
+
+    // The heatmap overrides the cell renderer; leaving it restores that choice
+    auto applyMode = [this, canvasAction, heatmapAction]()
+    {
+        if(heatmapAction->isChecked())
+        {
+            m_gridManager->setRenderMode(GridManager::HeatmapRendering);
+            statusBar()->showMessage("Heatmap overview", 2000);
+            return;
+        }
+        const bool canvas = canvasAction->isChecked();
+        m_gridManager->setRenderMode(canvas ? GridManager::CanvasRendering
+                                            : GridManager::WidgetRendering);
+        statusBar()->showMessage(canvas ? "Canvas rendering" : "Widget rendering", 2000);
+    };
+    connect(canvasAction, &QAction::toggled, this, applyMode);
+    connect(heatmapAction, &QAction::toggled, this, applyMode);
+    addAction(canvasAction);
+    addAction(heatmapAction);
+}
+
+void MainWindow::setupLayoutActions()
+{
+    QAction* autoLayoutAction = new QAction("Auto Layout", this);
+    autoLayoutAction->setCheckable(true);
+    autoLayoutAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_L));
+    connect(autoLayoutAction, &QAction::toggled, this, [this](bool enabled)
+            {
+                m_gridManager->setAutoLayout(enabled);
+                statusBar()->showMessage(enabled ? "Auto layout on" : "Auto layout off", 2000);
+            });
+    addAction(autoLayoutAction);
+
+    QAction* nextPageAction = new QAction("Next Page", this);
+    nextPageAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_PageDown));
+    connect(nextPageAction, &QAction::triggered, m_gridManager.data(), &GridManager::nextPage);
+    addAction(nextPageAction);
+
+    QAction* previousPageAction = new QAction("Previous Page", this);
+    previousPageAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_PageUp));
+    connect(previousPageAction, &QAction::triggered, m_gridManager.data(), &GridManager::previousPage);
+    addAction(previousPageAction);
+
+    connect(m_gridManager.data(), &GridManager::pageChanged, this, [this](int page, int pageCount)
+            {
+                statusBar()->showMessage(QString("Page %1 / %2").arg(page + 1).arg(pageCount), 2000);
+            });
+}
+
 void MainWindow::setupConnections()
 {
     connect(m_gridManager.data(), &GridManager::gridDimensionsChanged,
@@ -59,6 +136,60 @@ void MainWindow::resizeEvent(QResizeEvent* event)
     }
 }
 
+void MainWindow::showEvent(QShowEvent* event)
+{
+    QMainWindow::showEvent(event);
+
+    // Exposure (e.g. another virtual desktop) is only reported to the QWindow
+    if(windowHandle() && !m_exposeFilterInstalled)
+    {
+        windowHandle()->installEventFilter(this);
+        m_exposeFilterInstalled = true;
+    }
+    updatePowerMode();
+}
+
+void MainWindow::hideEvent(QHideEvent* event)
+{
+    QMainWindow::hideEvent(event);
+    updatePowerMode();
+}
+
+void MainWindow::changeEvent(QEvent* event)
+{
+    QMainWindow::changeEvent(event);
+    if(event->type() == QEvent::WindowStateChange || event->type() == QEvent::ActivationChange)
+    {
+        updatePowerMode();
+    }
+}
+
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if(watched == windowHandle() && event->type() == QEvent::Expose)
+    {
+        updatePowerMode();
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::updatePowerMode()
+{
+    if(!m_gridManager)
+        return;
+
+    GridManager::PowerMode mode = GridManager::Interactive;
+    if(!isVisible() || isMinimized() || (windowHandle() && !windowHandle()->isExposed()))
+    {
+        mode = GridManager::Background;
+    }
+    else if(!isActiveWindow())
+    {
+        mode = GridManager::Unfocused;
+    }
+    m_gridManager->setPowerMode(mode);
+}
+
 void MainWindow::handleGridDimensionsChanged()
 {
     updateWindowTitle();
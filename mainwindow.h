@@ -19,6 +19,10 @@ public:
 
 protected:
     void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private slots:
     void handleGridDimensionsChanged();
@@ -27,10 +31,15 @@ private slots:
 
 private:
     void setupUI();
+    void setupDebugPanel();
+    void setupRenderModeToggle();
+    void setupLayoutActions();
     void setupConnections();
     void updateWindowTitle();
+    void updatePowerMode();
 
     QScopedPointer<GridManager> m_gridManager;
+    bool m_exposeFilterInstalled = false;
 };
 
 #endif // MAINWINDOW_H